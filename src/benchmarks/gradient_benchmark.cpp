@@ -0,0 +1,221 @@
+// Measures the colorization throughput for each gradient in assets/gradients, with the colors searched and
+// interpolated per pixel, looked up in the baked table by the scalar kernel and by the vectorized kernel of
+// the CPU, and when switching to the gradient (only looking up the colors of the cached gradient positions).
+// Run it from the directory that contains assets/. With --check it instead compares the vectorized kernels
+// with the scalar kernels on random batches of points, which must produce exactly the same positions and pixels.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <CLI/App.hpp>
+#include <CLI/Config.hpp>
+#include <CLI/Formatter.hpp>
+#include <fmt/core.h>
+
+#include "gradient/gradient.h"
+#include "mandelbrot/colorize_kernels.h"
+#include "mandelbrot/kernel.h"
+#include "mandelbrot/mandelbrot.h"
+#include "messages/messages.h"
+#include "messages/result_layout.h"
+
+struct BenchmarkImage {
+    ImageSize image_size;
+    int max_iterations;
+    ResultLayout layout;
+    CalculationResults results_per_point;
+    std::vector<float> equalized_iterations;
+    GradientPositions gradient_positions;
+};
+
+void calculate_image(BenchmarkImage& image)
+{
+    const ImageSize& image_size = image.image_size;
+    const FractalSection section{-0.75, 0.1, 0.5};
+    OrbitStates orbits_per_point(image.layout.size(), OrbitState{});
+    Gradient gradient;
+
+    image.results_per_point.zero(0, image.layout.size());
+
+    (void) mandelbrot_calc(WorkerCalculate{
+        image.max_iterations, image_size, CalculationArea{0, 0, image_size.width, image_size.height}, section, CalculationStrategy::Full,
+        best_supported_kernel(), Precision::Double, nullptr, 0, 1, false, 0, nullptr, false, nullptr, &gradient, &image.results_per_point,
+        &orbits_per_point, image.layout, nullptr
+    });
+
+    std::vector<int> iterations_histogram(static_cast<std::size_t>(image.max_iterations + 1), 0);
+
+    for (int y = 0; y < image_size.height; ++y)
+        for (int x = 0; x < image_size.width; ++x)
+            ++iterations_histogram[static_cast<std::size_t>(image.results_per_point.iter(image.layout.index(x, y)))];
+
+    iterations_histogram.back() = 0;
+
+    image.equalized_iterations.resize(iterations_histogram.size());
+    equalize_histogram(iterations_histogram, image.max_iterations, image.equalized_iterations);
+}
+
+// Returns the seconds for all passes.
+double colorize(BenchmarkImage& image, const Kernel kernel, Gradient& gradient, const bool lookup_only, PixelBuffer& colorization_buffer, const int passes)
+{
+    WorkerColorize colorize{
+        image.max_iterations, 0, image.image_size.height, 0, image.image_size.width, image.image_size.width, 0, kernel, &gradient,
+        &image.results_per_point, image.layout, &image.equalized_iterations, &image.gradient_positions, lookup_only, &colorization_buffer
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int pass = 0; pass < passes; ++pass)
+        mandelbrot_colorize(colorize);
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// Random equalized iterations (increasing, not monotone, only zeros and maximums or partly outside the gradient),
+// gradients, lookup table sizes, iterations and fractions (including 0, 1 and values outside of 0 .. 1).
+// Returns the number of batches for which the kernels differ.
+int check_kernels(const Kernel kernel, const int batches)
+{
+    std::mt19937 rng(7);
+    const auto random_int = [&](const int n) { return static_cast<int>(rng() % static_cast<unsigned int>(n)); };
+
+    int mismatches = 0;
+
+    for (int batch = 0; batch < batches; ++batch) {
+        const int max_iterations = 1 + random_int(3000);
+        const int variant = batch % 4;
+        std::vector<float> equalized_iterations(static_cast<std::size_t>(max_iterations + 1));
+        float sum = 0.0f;
+
+        for (auto& e : equalized_iterations) {
+            if (variant == 0) {
+                sum += random_int(3) == 0 ? 0.0f : static_cast<float>(random_int(1000)) / 100.0f;
+                e = sum;
+            } else if (variant == 1) {
+                e = static_cast<float>(random_int(1000)) / 999.0f * static_cast<float>(max_iterations);
+            } else if (variant == 2) {
+                e = random_int(2) ? 0.0f : static_cast<float>(max_iterations);
+            } else {
+                e = std::uniform_real_distribution<float>(-0.1f * static_cast<float>(max_iterations), 1.1f * static_cast<float>(max_iterations))(rng);
+            }
+        }
+
+        if (variant == 0 && sum > 0.0f)
+            for (auto& e : equalized_iterations)
+                e = e / sum * static_cast<float>(max_iterations);
+
+        Gradient gradient{"check"};
+        gradient.colors = {{0.0f, 0.0f, 0.0f, 0.0f}, {static_cast<float>(random_int(100)) / 100.0f, 0.3f, 0.7f, 0.1f}, {1.0f, 1.0f, 0.5f, 1.0f}};
+        std::sort(gradient.colors.begin(), gradient.colors.end());
+        gradient.bake(2 + random_int(70000));
+
+        const int count = 1 + random_int(300);
+        const auto size = static_cast<std::size_t>(count);
+        std::vector<int> iterations(size);
+        std::vector<float> fractions(size);
+
+        for (std::size_t i = 0; i < size; ++i) {
+            iterations[i] = random_int(5) == 0 ? max_iterations : random_int(max_iterations);
+
+            const int fraction = random_int(10);
+            fractions[i] = fraction == 0 ? 0.0f : fraction == 1 ? 1.0f : fraction == 2 ? static_cast<float>(random_int(65536)) / 65535.0f : std::uniform_real_distribution<float>(-0.2f, 1.2f)(rng);
+        }
+
+        std::vector<float> scalar_positions(size), kernel_positions(size);
+        std::vector<sf::Uint8> scalar_pixels(4 * size), kernel_pixels(4 * size), scalar_lookup(4 * size), kernel_lookup(4 * size);
+
+        colorize_points_function(Kernel::Scalar, gradient)(iterations.data(), fractions.data(), count, max_iterations, equalized_iterations, gradient, scalar_positions.data(), scalar_pixels.data());
+        colorize_points_function(kernel, gradient)(iterations.data(), fractions.data(), count, max_iterations, equalized_iterations, gradient, kernel_positions.data(), kernel_pixels.data());
+        lookup_colors_function(Kernel::Scalar, gradient)(scalar_positions.data(), count, gradient, scalar_lookup.data());
+        lookup_colors_function(kernel, gradient)(kernel_positions.data(), count, gradient, kernel_lookup.data());
+
+        if (std::memcmp(scalar_positions.data(), kernel_positions.data(), size * sizeof(float)) != 0 || kernel_pixels != scalar_pixels
+            || scalar_lookup != scalar_pixels || kernel_lookup != scalar_pixels) {
+            if (mismatches < 5)
+                fmt::print("batch {}: the {} kernel differs from the scalar kernel\n", batch, kernel_name(kernel));
+
+            ++mismatches;
+        }
+    }
+
+    return mismatches;
+}
+
+int main(int argc, char* argv[])
+{
+    ImageSize image_size{1920, 1080};
+    int max_iterations = 1000;
+    int lookup_table_size = Gradient::default_lookup_table_size;
+    int passes = 10;
+    int check_batches = 0;
+
+    CLI::App app{"Gradient benchmark: colorization with searched vs. baked gradient colors, scalar vs. vectorized."};
+    app.add_option("--width", image_size.width, fmt::format("image width (default: {})", image_size.width))->check(CLI::PositiveNumber);
+    app.add_option("--height", image_size.height, fmt::format("image height (default: {})", image_size.height))->check(CLI::PositiveNumber);
+    app.add_option("-i,--max-iterations", max_iterations, fmt::format("maximum iterations (default: {})", max_iterations))->check(CLI::PositiveNumber);
+    app.add_option("-s,--gradient-size", lookup_table_size, fmt::format("number of colors precalculated per gradient (default: {})", lookup_table_size))->check(CLI::Range(2, 1 << 20));
+    app.add_option("-p,--passes", passes, fmt::format("colorization passes per gradient (default: {})", passes))->check(CLI::PositiveNumber);
+    app.add_option("-c,--check", check_batches, "compare the vectorized with the scalar kernels on this many random batches instead")->check(CLI::PositiveNumber);
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (check_batches > 0) {
+        const Kernel kernel = best_supported_kernel();
+        const int mismatches = check_kernels(kernel, check_batches);
+
+        fmt::print("{} kernel: {} of {} batches differ from the scalar kernel\n", kernel_name(kernel), mismatches, check_batches);
+        return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    const ResultLayout layout{ResultOrder::RowMajor, image_size};
+    BenchmarkImage image{image_size, max_iterations, layout, CalculationResults(layout.size(), false, max_iterations), {},
+        GradientPositions(static_cast<std::size_t>(image_size.width * image_size.height))};
+    calculate_image(image);
+
+    const std::size_t buffer_size = static_cast<std::size_t>(4 * image_size.width * image_size.height);
+    PixelBuffer searched_colors(buffer_size);
+    PixelBuffer baked_colors(buffer_size);
+    PixelBuffer vectorized_colors(buffer_size);
+    PixelBuffer switched_colors(buffer_size);
+
+    const Kernel kernel = best_supported_kernel();
+    const auto pixels = static_cast<double>(image_size.width) * static_cast<double>(image_size.height) * passes;
+
+    fmt::print("{}x{} points, {} iterations, {} passes, {} colors per gradient, {} kernel\n", image_size.width, image_size.height, max_iterations, passes, lookup_table_size, kernel_name(kernel));
+    fmt::print("{:12} {:>12} {:>12} {:>12} {:>12} {:>9} {:>10}\n", "gradient", "searched", "baked", "vectorized", "switch", "max diff", "identical");
+
+    std::vector<Gradient> gradients = load_available_gradients(lookup_table_size);
+
+    for (std::size_t g = 0; g < gradients.size(); ++g) {
+        Gradient& gradient = gradients[g];
+        Gradient searched = gradient;
+        searched.lookup_table.reset();
+
+        // switching from the previous gradient, whose colorization left the gradient positions of the image
+        (void) colorize(image, kernel, gradients[(g + gradients.size() - 1) % gradients.size()], false, switched_colors, 1);
+        const double switch_seconds = colorize(image, kernel, gradient, true, switched_colors, passes);
+
+        const double searched_seconds = colorize(image, Kernel::Scalar, searched, false, searched_colors, passes);
+        const double baked_seconds = colorize(image, Kernel::Scalar, gradient, false, baked_colors, passes);
+        const double vectorized_seconds = colorize(image, kernel, gradient, false, vectorized_colors, passes);
+
+        // largest difference of a color channel between searched and baked colors, the vectorized kernel and
+        // the switch must produce exactly the pixels of the scalar kernel
+        int max_difference = 0;
+
+        for (std::size_t i = 0; i < buffer_size; ++i)
+            max_difference = std::max(max_difference, std::abs(static_cast<int>(searched_colors[i]) - static_cast<int>(baked_colors[i])));
+
+        const bool identical = std::memcmp(baked_colors.data(), vectorized_colors.data(), buffer_size) == 0
+            && std::memcmp(baked_colors.data(), switched_colors.data(), buffer_size) == 0;
+
+        fmt::print("{:12} {:6.1f} Mpx/s {:6.1f} Mpx/s {:6.1f} Mpx/s {:6.1f} Mpx/s {:9} {:>10}\n", gradient.name_,
+            pixels / searched_seconds / 1e6, pixels / baked_seconds / 1e6, pixels / vectorized_seconds / 1e6, pixels / switch_seconds / 1e6,
+            max_difference, identical ? "yes" : "NO");
+    }
+}
@@ -0,0 +1,114 @@
+// Measures the message throughput of the mutex based and the lock-free message queue with
+// N producer and M consumer threads.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <CLI/App.hpp>
+#include <CLI/Config.hpp>
+#include <CLI/Formatter.hpp>
+#include <fmt/core.h>
+
+#include "messages/lock_free_message_queue.h"
+#include "messages/message_queue.h"
+
+// payload of roughly the size of a small worker message
+struct BenchmarkMessage {
+    std::int64_t value = 0;
+    std::int64_t padding[7]{};
+};
+
+struct BenchmarkResult {
+    double seconds;
+    bool complete;
+    QueueStatistics statistics;
+};
+
+template <typename Queue>
+BenchmarkResult run_benchmark(Queue& queue, const int producers, const int consumers, const int messages_per_producer)
+{
+    std::atomic<std::int64_t> received_sum = 0;
+    std::vector<std::thread> threads;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            std::int64_t sum = 0;
+
+            while (true) {
+                const BenchmarkMessage msg = queue.wait_for_message();
+
+                if (msg.value < 0)
+                    break;
+
+                sum += msg.value;
+            }
+
+            received_sum += sum;
+        });
+    }
+
+    std::vector<std::thread> producer_threads;
+
+    for (int p = 0; p < producers; ++p) {
+        producer_threads.emplace_back([&] {
+            for (int i = 1; i <= messages_per_producer; ++i)
+                queue.send(BenchmarkMessage{i});
+        });
+    }
+
+    for (auto& t : producer_threads)
+        t.join();
+
+    // one stop message per consumer, sent after all regular messages
+    for (int c = 0; c < consumers; ++c)
+        queue.send(BenchmarkMessage{-1});
+
+    for (auto& t : threads)
+        t.join();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const std::int64_t expected_sum = std::int64_t{producers} * messages_per_producer * (messages_per_producer + 1) / 2;
+
+    return BenchmarkResult{elapsed.count(), received_sum == expected_sum, queue.statistics()};
+}
+
+void print_result(const char* name, const BenchmarkResult& result, const std::int64_t messages)
+{
+    fmt::print("{:10} {:8.3f}s {:12.0f} msg/s  contended: {:10}  waits: {:8}{}\n",
+        name, result.seconds, static_cast<double>(messages) / result.seconds,
+        result.statistics.contended_locks, result.statistics.waits, result.complete ? "" : "  (messages lost!)");
+}
+
+int main(int argc, char* argv[])
+{
+    int producers = 1;
+    int consumers = static_cast<int>(std::thread::hardware_concurrency());
+    int messages = 1'000'000;
+    int capacity = static_cast<int>(LockFreeMessageQueue<BenchmarkMessage>::default_capacity);
+    int repetitions = 3;
+
+    CLI::App app{"Message queue benchmark: mutex based MessageQueue vs. LockFreeMessageQueue."};
+    app.add_option("-p,--producers", producers, fmt::format("number of producer threads (default: {})", producers))->check(CLI::PositiveNumber);
+    app.add_option("-c,--consumers", consumers, fmt::format("number of consumer threads (default: {})", consumers))->check(CLI::PositiveNumber);
+    app.add_option("-m,--messages", messages, fmt::format("messages per producer (default: {})", messages))->check(CLI::PositiveNumber);
+    app.add_option("--capacity", capacity, fmt::format("capacity of the lock-free queue (default: {})", capacity))->check(CLI::PositiveNumber);
+    app.add_option("-r,--repetitions", repetitions, fmt::format("number of runs per queue (default: {})", repetitions))->check(CLI::PositiveNumber);
+
+    CLI11_PARSE(app, argc, argv);
+
+    const std::int64_t total_messages = std::int64_t{producers} * messages;
+    fmt::print("{} producers, {} consumers, {} messages\n", producers, consumers, total_messages);
+
+    for (int r = 0; r < repetitions; ++r) {
+        MessageQueue<BenchmarkMessage> mutex_queue;
+        print_result("mutex", run_benchmark(mutex_queue, producers, consumers, messages), total_messages);
+
+        LockFreeMessageQueue<BenchmarkMessage> lock_free_queue{static_cast<std::size_t>(capacity)};
+        print_result("lock-free", run_benchmark(lock_free_queue, producers, consumers, messages), total_messages);
+    }
+}
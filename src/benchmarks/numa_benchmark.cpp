@@ -0,0 +1,166 @@
+// Measures how a memory bound pass over the per point buffers (like colorizing the image) scales from one
+// thread to all CPUs of all NUMA nodes, with the buffers first touched by the main thread (all pages on one
+// node) and by the threads that own the rows (pages spread over the nodes).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <latch>
+#include <thread>
+#include <vector>
+
+#include <CLI/App.hpp>
+#include <CLI/Config.hpp>
+#include <CLI/Formatter.hpp>
+#include <fmt/core.h>
+
+#include "messages/default_init_allocator.h"
+#include "worker/thread_placement.h"
+
+// same layout as CalculationResult
+struct BenchmarkPoint {
+    int iter;
+    float distance_to_next_iteration;
+};
+
+using Points = std::vector<BenchmarkPoint, DefaultInitAllocator<BenchmarkPoint>>;
+using Pixels = std::vector<std::uint8_t, DefaultInitAllocator<std::uint8_t>>;
+
+struct Slice {
+    std::size_t begin, end;
+};
+
+void first_touch(Points& points, Pixels& pixels, const Slice slice)
+{
+    for (std::size_t i = slice.begin; i < slice.end; ++i)
+        points[i] = BenchmarkPoint{static_cast<int>(i % 1024), 0.5f};
+
+    std::fill(pixels.begin() + static_cast<std::ptrdiff_t>(4 * slice.begin), pixels.begin() + static_cast<std::ptrdiff_t>(4 * slice.end), std::uint8_t{0});
+}
+
+// read every point and write its pixel, similar to mandelbrot_colorize
+void colorize_pass(const Points& points, Pixels& pixels, const Slice slice)
+{
+    for (std::size_t i = slice.begin; i < slice.end; ++i) {
+        const auto value = static_cast<std::uint8_t>(static_cast<float>(points[i].iter & 0xff) * points[i].distance_to_next_iteration);
+        pixels[4 * i] = value;
+        pixels[4 * i + 1] = value;
+        pixels[4 * i + 2] = value;
+        pixels[4 * i + 3] = 255;
+    }
+}
+
+// Returns the seconds for all passes, the time for allocating and touching the buffers is not included.
+double run_benchmark(const std::vector<ThreadPlacement>& placement, const bool pin, const bool owners_touch_first, const std::size_t num_points, const int passes)
+{
+    const auto num_threads = placement.size();
+
+    // the threads of a node get consecutive slices, like the row bands of the workers in the supervisor
+    std::vector<std::size_t> owners(num_threads);
+
+    for (std::size_t t = 0; t < num_threads; ++t)
+        owners[t] = t;
+
+    std::stable_sort(owners.begin(), owners.end(), [&](const std::size_t a, const std::size_t b) { return placement[a].node < placement[b].node; });
+
+    std::vector<Slice> slices(num_threads);
+
+    for (std::size_t i = 0; i < num_threads; ++i)
+        slices[owners[i]] = Slice{num_points * i / num_threads, num_points * (i + 1) / num_threads};
+
+    Points points(num_points);
+    Pixels pixels(4 * num_points);
+
+    if (!owners_touch_first)
+        first_touch(points, pixels, Slice{0, num_points});
+
+    std::latch ready{static_cast<std::ptrdiff_t>(num_threads + 1)};
+    std::latch start{1};
+    std::vector<std::thread> threads;
+
+    for (std::size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            if (pin)
+                pin_current_thread_to_cpu(placement[t].cpu);
+
+            if (owners_touch_first)
+                first_touch(points, pixels, slices[t]);
+
+            ready.count_down();
+            start.wait();
+
+            for (int pass = 0; pass < passes; ++pass)
+                colorize_pass(points, pixels, slices[t]);
+        });
+    }
+
+    ready.arrive_and_wait();
+
+    const auto start_time = std::chrono::steady_clock::now();
+    start.count_down();
+
+    for (auto& t : threads)
+        t.join();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+    return elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+    int width = 3840;
+    int height = 2160;
+    int passes = 20;
+    int max_threads = 0;
+    bool no_pinning = false;
+
+    CLI::App app{"NUMA benchmark: scaling of a colorization-like pass with main thread vs. owner first touch."};
+    app.add_option("--width", width, fmt::format("image width (default: {})", width))->check(CLI::PositiveNumber);
+    app.add_option("--height", height, fmt::format("image height (default: {})", height))->check(CLI::PositiveNumber);
+    app.add_option("-p,--passes", passes, fmt::format("passes over the image per run (default: {})", passes))->check(CLI::PositiveNumber);
+    app.add_option("-n,--threads", max_threads, "maximum number of threads (default: all CPUs of all NUMA nodes)")->check(CLI::PositiveNumber);
+    app.add_flag("--no-pinning", no_pinning, "do not pin the threads to CPUs");
+
+    CLI11_PARSE(app, argc, argv);
+
+    const NumaTopology topology = numa_topology();
+    int num_cpus = 0;
+
+    for (int node = 0; node < topology.number_of_nodes(); ++node) {
+        const auto& cpus = topology.node_cpus[static_cast<std::size_t>(node)];
+        num_cpus += static_cast<int>(cpus.size());
+        fmt::print("NUMA node {}: {} CPUs\n", node, cpus.size());
+    }
+
+    if (max_threads == 0)
+        max_threads = num_cpus;
+
+    // 1, 2, 4, ... threads and all CPUs
+    std::vector<int> thread_counts;
+
+    for (int threads = 1; threads < max_threads; threads *= 2)
+        thread_counts.push_back(threads);
+
+    thread_counts.push_back(max_threads);
+
+    const auto num_points = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+    const double bytes_per_pass = static_cast<double>(num_points) * (sizeof(BenchmarkPoint) + 4);
+    double single_thread_seconds = 0.0;
+
+    fmt::print("{}x{} points, {} passes, threads {}\n", width, height, passes, no_pinning ? "not pinned" : "pinned, spread over the NUMA nodes");
+    fmt::print("{:>8} {:>24} {:>24} {:>8}\n", "threads", "main thread first touch", "owner first touch", "speedup");
+
+    for (const int threads : thread_counts) {
+        const auto placement = spread_threads(topology, threads);
+        const double main_touch = run_benchmark(placement, !no_pinning, false, num_points, passes);
+        const double owner_touch = run_benchmark(placement, !no_pinning, true, num_points, passes);
+
+        if (threads == 1)
+            single_thread_seconds = owner_touch;
+
+        fmt::print("{:8} {:8.3f}s {:9.2f} GB/s {:8.3f}s {:9.2f} GB/s {:7.2f}x\n", threads,
+            main_touch, bytes_per_pass * passes / main_touch / 1e9,
+            owner_touch, bytes_per_pass * passes / owner_touch / 1e9,
+            single_thread_seconds / owner_touch);
+    }
+}
@@ -0,0 +1,149 @@
+// Measures the calculation and colorization throughput of the row-major and the tile-major layout of
+// the calculation results (array of structures and compact), with the tiles of the image calculated by
+// several threads at once.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <CLI/App.hpp>
+#include <CLI/Config.hpp>
+#include <CLI/Formatter.hpp>
+#include <fmt/core.h>
+
+#include "gradient/gradient.h"
+#include "mandelbrot/kernel.h"
+#include "mandelbrot/mandelbrot.h"
+#include "messages/messages.h"
+#include "messages/result_layout.h"
+
+struct BenchmarkOptions {
+    ImageSize image_size;
+    int tile_size;
+    int max_iterations;
+    int threads;
+};
+
+struct BenchmarkStorage {
+    ResultOrder order;
+    bool compact;
+};
+
+struct BenchmarkResult {
+    double calculation_seconds;
+    double colorization_seconds;
+};
+
+template <typename Function>
+double run_threads(const int threads, const Function& function)
+{
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back(function, t);
+
+    for (auto& w : workers)
+        w.join();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+BenchmarkResult run_benchmark(const BenchmarkStorage storage, const BenchmarkOptions& options, const Gradient& gradient)
+{
+    const ImageSize& image_size = options.image_size;
+    const ResultLayout layout{storage.order, image_size};
+    const FractalSection section{-0.8, 0.0, 2.0};
+    const Kernel kernel = best_supported_kernel();
+
+    CalculationResults results_per_point(layout.size(), storage.compact, options.max_iterations);
+    results_per_point.zero(0, layout.size());
+    OrbitStates orbits_per_point(layout.size(), OrbitState{});
+    GradientPositions gradient_positions(static_cast<std::size_t>(image_size.width * image_size.height), 0.0f);
+    PixelBuffer colorization_buffer(static_cast<std::size_t>(4 * image_size.width * image_size.height), 0);
+
+    std::vector<CalculationArea> tiles;
+
+    for (int y = 0; y < image_size.height; y += options.tile_size)
+        for (int x = 0; x < image_size.width; x += options.tile_size)
+            tiles.push_back(CalculationArea{x, y, std::min(options.tile_size, image_size.width - x), std::min(options.tile_size, image_size.height - y)});
+
+    // the threads take the tiles in row-major order, so neighboring tiles are calculated at the same time
+    std::atomic<std::size_t> next_tile = 0;
+
+    const double calculation_seconds = run_threads(options.threads, [&](int) {
+        for (std::size_t i = next_tile++; i < tiles.size(); i = next_tile++) {
+            (void) mandelbrot_calc(WorkerCalculate{
+                options.max_iterations, image_size, tiles[i], section, CalculationStrategy::Full, kernel, Precision::Double, nullptr,
+                0, 1, false, 0, nullptr, false, nullptr, &gradient, &results_per_point, &orbits_per_point, layout, nullptr
+            });
+        }
+    });
+
+    std::vector<int> iterations_histogram(static_cast<std::size_t>(options.max_iterations + 1), 0);
+
+    for (int y = 0; y < image_size.height; ++y)
+        for (int x = 0; x < image_size.width; ++x)
+            ++iterations_histogram[static_cast<std::size_t>(results_per_point.iter(layout.index(x, y)))];
+
+    iterations_histogram.back() = 0;
+
+    std::vector<float> equalized_iterations(iterations_histogram.size());
+    equalize_histogram(iterations_histogram, options.max_iterations, equalized_iterations);
+
+    Gradient colorize_gradient = gradient;
+
+    const double colorization_seconds = run_threads(options.threads, [&](const int t) {
+        const int start_row = image_size.height * t / options.threads;
+        const int end_row = image_size.height * (t + 1) / options.threads;
+
+        WorkerColorize colorize{
+            options.max_iterations, start_row, end_row - start_row, 0, image_size.width, image_size.width, 0, kernel, &colorize_gradient,
+            &results_per_point, layout, &equalized_iterations, &gradient_positions, false, &colorization_buffer
+        };
+
+        mandelbrot_colorize(colorize);
+    });
+
+    return BenchmarkResult{calculation_seconds, colorization_seconds};
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options{{1920, 1080}, 50, 1000, static_cast<int>(std::thread::hardware_concurrency())};
+    int repetitions = 3;
+
+    CLI::App app{"Result layout benchmark: row-major vs. tile-major, array of structures vs. compact calculation results."};
+    app.add_option("--width", options.image_size.width, fmt::format("image width (default: {})", options.image_size.width))->check(CLI::PositiveNumber);
+    app.add_option("--height", options.image_size.height, fmt::format("image height (default: {})", options.image_size.height))->check(CLI::PositiveNumber);
+    app.add_option("-t,--tile-size", options.tile_size, fmt::format("tile size (default: {})", options.tile_size))->check(CLI::PositiveNumber);
+    app.add_option("-i,--max-iterations", options.max_iterations, fmt::format("maximum iterations (default: {})", options.max_iterations))->check(CLI::PositiveNumber);
+    app.add_option("-n,--threads", options.threads, fmt::format("number of threads (default: {})", options.threads))->check(CLI::PositiveNumber);
+    app.add_option("-r,--repetitions", repetitions, fmt::format("number of runs per layout (default: {})", repetitions))->check(CLI::PositiveNumber);
+
+    CLI11_PARSE(app, argc, argv);
+
+    Gradient gradient{"benchmark"};
+    gradient.colors = {{0.0f, 0.0f, 0.0f, 0.5f}, {0.5f, 1.0f, 0.8f, 0.0f}, {1.0f, 1.0f, 1.0f, 1.0f}};
+
+    const auto points = static_cast<double>(options.image_size.width) * static_cast<double>(options.image_size.height);
+
+    fmt::print("{}x{} points, {}x{} tiles, {} iterations, {} threads\n", options.image_size.width, options.image_size.height,
+        options.tile_size, options.tile_size, options.max_iterations, options.threads);
+
+    for (int r = 0; r < repetitions; ++r) {
+        for (const auto order : {ResultOrder::RowMajor, ResultOrder::TileMajor}) {
+            for (const bool compact : {false, true}) {
+                const BenchmarkResult result = run_benchmark(BenchmarkStorage{order, compact}, options, gradient);
+
+                fmt::print("{:6} {:8} calculation: {:7.3f}s {:8.2f} Mpoints/s   colorization: {:7.3f}s {:8.2f} Mpoints/s\n", result_order_name(order), compact ? "compact" : "aos",
+                    result.calculation_seconds, points / result.calculation_seconds / 1e6,
+                    result.colorization_seconds, points / result.colorization_seconds / 1e6);
+            }
+        }
+    }
+}
@@ -2,6 +2,7 @@
 
 #include <cstdlib>
 #include <filesystem>
+#include <map>
 #include <string>
 #include <thread>
 
@@ -11,6 +12,8 @@
 #include <fmt/core.h>
 #include <spdlog/spdlog.h>
 
+#include "gradient/gradient.h"
+
 CommandLine::CommandLine(int argc, char* argv[])
 {
     const auto description = "A multi-threaded C++ Mandelbrot renderer using SFML + ImGui.";
@@ -20,15 +23,35 @@ CommandLine::CommandLine(int argc, char* argv[])
     default_fullscreen_video_mode_ = default_video_mode(true);
 
     fullscreen_ = false;
+    pin_threads_ = false;
+    kernel_ = Kernel::Auto;
+    scheduler_ = Scheduler::SharedQueue;
+    tile_order_ = TileOrder::RowMajor;
+    result_order_ = ResultOrder::RowMajor;
+    compact_results_ = false;
+    gradient_lookup_table_size_ = Gradient::default_lookup_table_size;
     num_threads_ = static_cast<int>(std::thread::hardware_concurrency());
     font_size_ = default_font_size();
     window_width_ = default_window_video_mode_.width;
     window_height_ = default_window_video_mode_.height;
 
+    const std::map<std::string, Kernel> kernels{
+        {"auto", Kernel::Auto}, {"scalar", Kernel::Scalar}, {"sse2", Kernel::SSE2}, {"avx2", Kernel::AVX2}, {"avx512", Kernel::AVX512}};
+    const std::map<std::string, Scheduler> schedulers{{"shared", Scheduler::SharedQueue}, {"lockfree", Scheduler::LockFree}, {"stealing", Scheduler::WorkStealing}};
+    const std::map<std::string, TileOrder> tile_orders{{"rows", TileOrder::RowMajor}, {"cost", TileOrder::CostFirst}, {"center", TileOrder::CenterOut}};
+    const std::map<std::string, ResultOrder> result_orders{{"rows", ResultOrder::RowMajor}, {"tiles", ResultOrder::TileMajor}};
+
     CLI::App app{description};
     app.add_flag("-v", log_level_flag, "log level (-v: INFO, -vv: DEBUG, -vvv: TRACE)");
     app.add_option("-n,--threads", num_threads_, fmt::format("number of threads (default: number of concurrent threads supported by the system: {})", num_threads_))->check(CLI::PositiveNumber);
+    app.add_flag("--pin-threads", pin_threads_, fmt::format("pin the worker threads to CPUs, spread over the NUMA nodes (default: {})", pin_threads_));
     app.add_option("--font-size", font_size_, fmt::format("UI font size in pixels (default: {})", font_size_))->check(CLI::PositiveNumber);
+    app.add_option("--kernel", kernel_, "calculation kernel: auto, scalar, sse2, avx2, avx512 (default: auto, the fastest kernel supported by the CPU)")->transform(CLI::CheckedTransformer(kernels, CLI::ignore_case));
+    app.add_option("--scheduler", scheduler_, "worker scheduling: shared (one queue for all threads), lockfree (one lock-free queue for all threads), stealing (per-thread queues with work stealing) (default: shared)")->transform(CLI::CheckedTransformer(schedulers, CLI::ignore_case));
+    app.add_option("--tile-order", tile_order_, "tile order: rows (row by row), cost (most expensive tiles of the previous image first), center (from the center outwards) (default: rows)")->transform(CLI::CheckedTransformer(tile_orders, CLI::ignore_case));
+    app.add_option("--result-layout", result_order_, "memory layout of the calculation results: rows (row-major), tiles (tile-major, 8x8 point tiles) (default: rows)")->transform(CLI::CheckedTransformer(result_orders, CLI::ignore_case));
+    app.add_flag("--compact-results", compact_results_, fmt::format("store the calculation results compact: iterations as 8/16/32 bit integers (depending on the maximum iterations), 16 bit fractions (default: {})", compact_results_));
+    app.add_option("--gradient-size", gradient_lookup_table_size_, fmt::format("number of colors precalculated per gradient (default: {})", gradient_lookup_table_size_))->check(CLI::Range(2, 1 << 20));
     auto opt_fullscreen = app.add_flag("-f,--fullscreen", fullscreen_, fmt::format("fullscreen (default: {})", fullscreen_));
     auto opt_width = app.add_option("--width", window_width_, fmt::format("window width (windowed mode only, default: {})", window_width_));
     auto opt_height = app.add_option("--height", window_height_, fmt::format("window height (windowed mode only, default: {})", window_height_));
@@ -57,8 +80,23 @@ CommandLine::CommandLine(int argc, char* argv[])
     }
 
     spdlog::set_level(log_level);
+
+    if (kernel_ == Kernel::Auto) {
+        kernel_ = best_supported_kernel();
+    } else if (!kernel_supported(kernel_)) {
+        spdlog::warn("calculation kernel {} is not supported by this CPU", kernel_name(kernel_));
+        kernel_ = best_supported_kernel();
+    }
+
     spdlog::debug("command line option --fullscreen: {}", fullscreen_);
     spdlog::debug("command line option --threads: {}", num_threads_);
+    spdlog::debug("command line option --pin-threads: {}", pin_threads_);
+    spdlog::debug("command line option --kernel: {}", kernel_name(kernel_));
+    spdlog::debug("command line option --scheduler: {}", scheduler_name(scheduler_));
+    spdlog::debug("command line option --tile-order: {}", tile_order_name(tile_order_));
+    spdlog::debug("command line option --result-layout: {}", result_order_name(result_order_));
+    spdlog::debug("command line option --compact-results: {}", compact_results_);
+    spdlog::debug("command line option --gradient-size: {}", gradient_lookup_table_size_);
     spdlog::debug("command line option --font-size: {}", font_size_);
     spdlog::debug("command line option --width: {}", window_width_);
     spdlog::debug("command line option --height: {}", window_height_);
@@ -5,10 +5,22 @@
 #include <CLI/App.hpp>
 #include <SFML/Window/VideoMode.hpp>
 
+#include "mandelbrot/kernel.h"
+#include "messages/result_layout.h"
+#include "messages/scheduler.h"
+#include "supervisor/tile_order.h"
+
 class CommandLine {
     bool fullscreen_;
+    bool pin_threads_;
     int num_threads_;
     int font_size_;
+    Kernel kernel_;
+    Scheduler scheduler_;
+    TileOrder tile_order_;
+    ResultOrder result_order_;
+    bool compact_results_;
+    int gradient_lookup_table_size_;
     int window_width_;
     int window_height_;
     sf::VideoMode video_mode_;
@@ -24,7 +36,14 @@ public:
 
     [[nodiscard]] bool fullscreen() const { return fullscreen_; }
     [[nodiscard]] int num_threads() const { return num_threads_; }
+    [[nodiscard]] bool pin_threads() const { return pin_threads_; }
     [[nodiscard]] int font_size() const { return font_size_; }
+    [[nodiscard]] Kernel kernel() const { return kernel_; }
+    [[nodiscard]] Scheduler scheduler() const { return scheduler_; }
+    [[nodiscard]] TileOrder tile_order() const { return tile_order_; }
+    [[nodiscard]] ResultOrder result_order() const { return result_order_; }
+    [[nodiscard]] bool compact_results() const { return compact_results_; }
+    [[nodiscard]] int gradient_lookup_table_size() const { return gradient_lookup_table_size_; }
     [[nodiscard]] sf::VideoMode video_mode() const { return video_mode_; };
     [[nodiscard]] sf::VideoMode default_window_video_mode() const { return default_window_video_mode_; };
     [[nodiscard]] sf::VideoMode default_fullscreen_video_mode() const { return default_fullscreen_video_mode_; };
@@ -12,7 +12,6 @@
 
 #include <fmt/ostream.h>
 #include <spdlog/spdlog.h>
-#include <SFML/Graphics/Color.hpp>
 
 const std::string gradients_directory = "assets/gradients";
 
@@ -27,7 +26,7 @@ bool equal_enough(float a, float b) noexcept
     return std::abs(a - b) <= std::max(a, b) * epsilon;
 }
 
-Gradient load_gradient(const std::string& name)
+Gradient load_gradient(const std::string& name, const int lookup_table_size)
 {
     auto path = std::filesystem::path{gradients_directory} / (name + ".gradient");
 
@@ -59,9 +58,24 @@ Gradient load_gradient(const std::string& name)
     }
 
     std::sort(gradient.colors.begin(), gradient.colors.end());
+    gradient.bake(lookup_table_size);
+
     return gradient;
 }
 
+// Precalculate the colors, so that colorizing a pixel is a table lookup instead of searching the colors
+// and interpolating between them.
+void Gradient::bake(const int lookup_table_size)
+{
+    std::vector<sf::Color> table(static_cast<std::size_t>(std::max(2, lookup_table_size)));
+    const auto last = static_cast<float>(table.size() - 1);
+
+    for (std::size_t i = 0; i < table.size(); ++i)
+        table[i] = color_from_gradient(*this, static_cast<float>(i) / last);
+
+    lookup_table = std::make_shared<const std::vector<sf::Color>>(std::move(table));
+}
+
 sf::Color color_from_gradient_range(const GradientColor& left, const GradientColor& right, const float pos) noexcept
 {
     const float relative_pos_between_colors = (pos - left.pos) / (right.pos - left.pos);
@@ -83,12 +97,12 @@ sf::Color color_from_gradient(const Gradient& gradient, const float pos) noexcep
         return sf::Color::Black;
 }
 
-std::vector<Gradient> load_available_gradients()
+std::vector<Gradient> load_available_gradients(const int lookup_table_size)
 {
     std::vector<Gradient> available_gradients;
 
     for (const auto& p : std::filesystem::directory_iterator(gradients_directory))
-        available_gradients.push_back(load_gradient(p.path().filename().replace_extension("").string()));
+        available_gradients.push_back(load_gradient(p.path().filename().replace_extension("").string(), lookup_table_size));
 
     std::sort(available_gradients.begin(), available_gradients.end(),
         [](const Gradient& a, const Gradient& b) { return a.name_ < b.name_; });
@@ -1,11 +1,10 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
-namespace sf {
-    class Color;
-}
+#include <SFML/Graphics/Color.hpp>
 
 bool equal_enough(float a, float b) noexcept;
 
@@ -17,13 +16,36 @@ struct GradientColor {
 };
 
 struct Gradient {
+    static constexpr int default_lookup_table_size = 4096;
+
     std::string name_;
     std::vector<GradientColor> colors;
 
+    // Colors at evenly spaced positions 0.0 .. 1.0, baked from colors by bake(). Shared between the copies
+    // of the gradient in the colorization messages.
+    std::shared_ptr<const std::vector<sf::Color>> lookup_table;
+
     Gradient() : name_{""} {}
     Gradient(std::string name) : name_{name} {}
+
+    void bake(const int lookup_table_size);
+    [[nodiscard]] sf::Color color_at(const float pos) const noexcept;
 };
 
-Gradient load_gradient(const std::string& name);
+Gradient load_gradient(const std::string& name, const int lookup_table_size = Gradient::default_lookup_table_size);
 sf::Color color_from_gradient(const Gradient& gradient, const float pos) noexcept;
-std::vector<Gradient> load_available_gradients();
+std::vector<Gradient> load_available_gradients(const int lookup_table_size = Gradient::default_lookup_table_size);
+
+// The color of the nearest entry of the lookup table, or searched in the colors if the gradient is not baked.
+// Positions outside 0.0 .. 1.0 are black.
+inline sf::Color Gradient::color_at(const float pos) const noexcept
+{
+    if (!lookup_table)
+        return color_from_gradient(*this, pos);
+
+    if (!(pos >= 0.0f && pos <= 1.0f))
+        return sf::Color::Black;
+
+    const auto& table = *lookup_table;
+    return table[static_cast<std::size_t>(pos * static_cast<float>(table.size() - 1) + 0.5f)];
+}
@@ -0,0 +1,167 @@
+#include "colorize_kernels.h"
+
+#include "mandelbrot.h"
+
+#ifdef MANDELBROT_X86_64
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define KERNEL_TARGET(isa) __attribute__((target(isa)))
+#else
+#define KERNEL_TARGET(isa)
+#endif
+
+void colorize_points_scalar(const int* iterations, const float* fractions, const int count, const int max_iterations, const std::vector<float>& equalized_iterations, const Gradient& gradient, float* positions, sf::Uint8* pixels) noexcept
+{
+    for (int i = 0; i < count; ++i) {
+        const float pos = gradient_position(CalculationResult{iterations[i], fractions[i]}, max_iterations, equalized_iterations);
+        const auto color = gradient.color_at(pos);
+
+        *positions++ = pos;
+        *pixels++ = color.r;
+        *pixels++ = color.g;
+        *pixels++ = color.b;
+        *pixels++ = color.a;
+    }
+}
+
+void lookup_colors_scalar(const float* positions, const int count, const Gradient& gradient, sf::Uint8* pixels) noexcept
+{
+    for (int i = 0; i < count; ++i) {
+        const auto color = gradient.color_at(positions[i]);
+
+        *pixels++ = color.r;
+        *pixels++ = color.g;
+        *pixels++ = color.b;
+        *pixels++ = color.a;
+    }
+}
+
+#ifdef MANDELBROT_X86_64
+
+// The same operations as std::lerp of libstdc++, so that the result is bit-identical to the scalar kernel.
+KERNEL_TARGET("avx2")
+[[nodiscard]] __m256 lerp_avx2(const __m256 a, const __m256 b, const __m256 t) noexcept
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    // a and b on different sides of zero: t * b + (1 - t) * a
+    const __m256 different_signs = _mm256_or_ps(
+        _mm256_and_ps(_mm256_cmp_ps(a, zero, _CMP_LE_OQ), _mm256_cmp_ps(b, zero, _CMP_GE_OQ)),
+        _mm256_and_ps(_mm256_cmp_ps(a, zero, _CMP_GE_OQ), _mm256_cmp_ps(b, zero, _CMP_LE_OQ)));
+    const __m256 weighted = _mm256_add_ps(_mm256_mul_ps(t, b), _mm256_mul_ps(_mm256_sub_ps(one, t), a));
+
+    // otherwise a + t * (b - a), bounded by b, or b itself if t is 1
+    const __m256 x = _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+    const __m256 same_direction = _mm256_xor_ps(_mm256_cmp_ps(t, one, _CMP_GT_OQ), _mm256_cmp_ps(b, a, _CMP_GT_OQ));
+    const __m256 bounded = _mm256_blendv_ps(_mm256_max_ps(x, b), _mm256_min_ps(x, b), same_direction);
+    const __m256 interpolated = _mm256_blendv_ps(bounded, b, _mm256_cmp_ps(t, one, _CMP_EQ_OQ));
+
+    return _mm256_blendv_ps(interpolated, weighted, different_signs);
+}
+
+// Colors of eight positions from the lookup table of the gradient, positions outside 0.0 .. 1.0 are black.
+KERNEL_TARGET("avx2")
+[[nodiscard]] __m256i gradient_colors_avx2(const __m256 pos_in_gradient, const int* colors, const __m256 last_color) noexcept
+{
+    const __m256i black = _mm256_set1_epi32(static_cast<int>(0xff000000u));  // r, g, b = 0, a = 255
+
+    const __m256 in_gradient = _mm256_and_ps(_mm256_cmp_ps(pos_in_gradient, _mm256_setzero_ps(), _CMP_GE_OQ), _mm256_cmp_ps(pos_in_gradient, _mm256_set1_ps(1.0f), _CMP_LE_OQ));
+    const __m256i color_index = _mm256_and_si256(_mm256_castps_si256(in_gradient),
+        _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(pos_in_gradient, last_color), _mm256_set1_ps(0.5f))));
+
+    return _mm256_blendv_epi8(black, _mm256_i32gather_epi32(colors, color_index, 4), _mm256_castps_si256(in_gradient));
+}
+
+// Eight points at a time: gather the equalized iterations, interpolate the position in the gradient, gather
+// the colors from the lookup table and store them as packed RGBA. Points inside the Mandelbrot set get a
+// position outside the gradient and are black.
+KERNEL_TARGET("avx2")
+void colorize_points_avx2(const int* iterations, const float* fractions, const int count, const int max_iterations, const std::vector<float>& equalized_iterations, const Gradient& gradient, float* positions, sf::Uint8* pixels) noexcept
+{
+    constexpr int lanes = 8;
+
+    const std::vector<sf::Color>& lookup_table = *gradient.lookup_table;
+    const auto* colors = reinterpret_cast<const int*>(lookup_table.data());
+    const float* equalized = equalized_iterations.data();
+
+    const __m256i max_iter = _mm256_set1_epi32(max_iterations);
+    const __m256i last_escaped_iter = _mm256_set1_epi32(max_iterations - 1);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256 max_iterations_ps = _mm256_set1_ps(static_cast<float>(max_iterations));
+    const __m256 inside_set = _mm256_set1_ps(inside_set_gradient_position);
+    const __m256 last_color = _mm256_set1_ps(static_cast<float>(lookup_table.size() - 1));
+
+    int i = 0;
+
+    for (; i + lanes <= count; i += lanes) {
+        const __m256i iter = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(iterations + i));
+        const __m256i inside = _mm256_cmpeq_epi32(iter, max_iter);
+
+        // the points inside the set have no next iteration, clamp their index (their position is replaced anyway)
+        const __m256i index = _mm256_min_epi32(iter, last_escaped_iter);
+        const __m256 iter_curr = _mm256_i32gather_ps(equalized, index, 4);
+        const __m256 iter_next = _mm256_i32gather_ps(equalized, _mm256_add_epi32(index, one), 4);
+
+        const __m256 smoothed_iteration = lerp_avx2(iter_curr, iter_next, _mm256_loadu_ps(fractions + i));
+        const __m256 pos_in_gradient = _mm256_blendv_ps(_mm256_div_ps(smoothed_iteration, max_iterations_ps), inside_set, _mm256_castsi256_ps(inside));
+
+        _mm256_storeu_ps(positions + i, pos_in_gradient);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + 4 * i), gradient_colors_avx2(pos_in_gradient, colors, last_color));
+    }
+
+    colorize_points_scalar(iterations + i, fractions + i, count - i, max_iterations, equalized_iterations, gradient, positions + i, pixels + 4 * i);
+}
+
+KERNEL_TARGET("avx2")
+void lookup_colors_avx2(const float* positions, const int count, const Gradient& gradient, sf::Uint8* pixels) noexcept
+{
+    constexpr int lanes = 8;
+
+    const std::vector<sf::Color>& lookup_table = *gradient.lookup_table;
+    const auto* colors = reinterpret_cast<const int*>(lookup_table.data());
+    const __m256 last_color = _mm256_set1_ps(static_cast<float>(lookup_table.size() - 1));
+
+    int i = 0;
+
+    for (; i + lanes <= count; i += lanes)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + 4 * i), gradient_colors_avx2(_mm256_loadu_ps(positions + i), colors, last_color));
+
+    lookup_colors_scalar(positions + i, count - i, gradient, pixels + 4 * i);
+}
+
+#endif
+
+[[nodiscard]] ColorizePointsFunction colorize_points_function(const Kernel kernel, const Gradient& gradient) noexcept
+{
+    if (!gradient.lookup_table)
+        return colorize_points_scalar;
+
+    switch (kernel) {
+#ifdef MANDELBROT_X86_64
+    case Kernel::AVX2:
+    case Kernel::AVX512:
+        return colorize_points_avx2;
+#endif
+    default:
+        return colorize_points_scalar;
+    }
+}
+
+[[nodiscard]] LookupColorsFunction lookup_colors_function(const Kernel kernel, const Gradient& gradient) noexcept
+{
+    if (!gradient.lookup_table)
+        return lookup_colors_scalar;
+
+    switch (kernel) {
+#ifdef MANDELBROT_X86_64
+    case Kernel::AVX2:
+    case Kernel::AVX512:
+        return lookup_colors_avx2;
+#endif
+    default:
+        return lookup_colors_scalar;
+    }
+}
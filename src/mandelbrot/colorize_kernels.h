@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+
+#include <SFML/Config.hpp>
+
+#include "kernel.h"
+#include "gradient/gradient.h"
+
+// Colorize count consecutive points with the given iterations and fractions (distance_to_next_iteration),
+// storing their positions in the gradient (see gradient_position) into positions and the colors as packed
+// RGBA (4 bytes per point in memory order r, g, b, a) into pixels.
+using ColorizePointsFunction = void (*)(const int* iterations, const float* fractions, const int count, const int max_iterations, const std::vector<float>& equalized_iterations, const Gradient& gradient, float* positions, sf::Uint8* pixels) noexcept;
+
+// Store the colors of count points with the given positions in the gradient as packed RGBA into pixels.
+using LookupColorsFunction = void (*)(const float* positions, const int count, const Gradient& gradient, sf::Uint8* pixels) noexcept;
+
+// Kernels for the given instruction set. The vectorized kernels need a baked gradient and produce exactly
+// the same positions and pixels as the scalar kernels.
+[[nodiscard]] ColorizePointsFunction colorize_points_function(const Kernel kernel, const Gradient& gradient) noexcept;
+[[nodiscard]] LookupColorsFunction lookup_colors_function(const Kernel kernel, const Gradient& gradient) noexcept;
@@ -0,0 +1,165 @@
+#include "fixed_point.h"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr double limb_base = 4294967296.0;  // 2^32
+
+// Compare the magnitudes of two equally sized limb vectors.
+int compare_magnitudes(const std::vector<std::uint32_t>& a, const std::vector<std::uint32_t>& b)
+{
+    for (std::size_t i = 0; i < a.size(); ++i)
+        if (a[i] != b[i])
+            return a[i] < b[i] ? -1 : 1;
+
+    return 0;
+}
+
+// Split the magnitude of a double into limbs. If fraction_limbs is negative use as many limbs as
+// needed to represent the value exactly.
+std::vector<std::uint32_t> double_to_limbs(const double value, const int fraction_limbs)
+{
+    const double magnitude = std::min(std::abs(value), limb_base - 1.0);
+    double integer_part;
+    double fraction = std::modf(magnitude, &integer_part);
+
+    std::vector<std::uint32_t> limbs{static_cast<std::uint32_t>(integer_part)};
+
+    const auto more_limbs_needed = [&] {
+        if (fraction_limbs >= 0)
+            return std::ssize(limbs) <= fraction_limbs;
+
+        return (fraction > 0.0 || std::ssize(limbs) <= 2) && std::ssize(limbs) <= FixedPoint::max_fraction_limbs;
+    };
+
+    while (more_limbs_needed()) {
+        // multiplying by 2^32 and splitting off the integer part is exact for doubles
+        fraction = std::modf(fraction * limb_base, &integer_part);
+        limbs.push_back(static_cast<std::uint32_t>(integer_part));
+    }
+
+    return limbs;
+}
+
+FixedPoint::FixedPoint(const bool negative, std::vector<std::uint32_t> limbs) : limbs_{std::move(limbs)}
+{
+    // no negative zero, so that equal values have equal signs
+    negative_ = negative && std::any_of(limbs_.begin(), limbs_.end(), [](const std::uint32_t limb) { return limb != 0; });
+}
+
+FixedPoint::FixedPoint(const double value) : FixedPoint(std::signbit(value), double_to_limbs(value, -1))
+{
+}
+
+FixedPoint::FixedPoint(const double value, const int fraction_limbs) : FixedPoint(std::signbit(value), double_to_limbs(value, fraction_limbs))
+{
+}
+
+// Equal values with a different number of fraction limbs only differ by trailing zero limbs.
+bool FixedPoint::operator==(const FixedPoint& other) const
+{
+    const auto& shorter = limbs_.size() <= other.limbs_.size() ? limbs_ : other.limbs_;
+    const auto& longer = limbs_.size() <= other.limbs_.size() ? other.limbs_ : limbs_;
+
+    return negative_ == other.negative_ && std::equal(shorter.begin(), shorter.end(), longer.begin())
+        && std::all_of(longer.begin() + std::ssize(shorter), longer.end(), [](const std::uint32_t limb) { return limb == 0; });
+}
+
+[[nodiscard]] FixedPoint FixedPoint::with_fraction_limbs(const int fraction_limbs) const
+{
+    FixedPoint result = *this;
+    result.limbs_.resize(static_cast<std::size_t>(fraction_limbs + 1), 0);
+    return result;
+}
+
+[[nodiscard]] double FixedPoint::to_double() const
+{
+    double value = 0.0;
+
+    // add the least significant limbs first
+    for (int i = static_cast<int>(limbs_.size()) - 1; i >= 0; --i)
+        value += std::ldexp(static_cast<double>(limbs_[static_cast<std::size_t>(i)]), -32 * i);
+
+    return negative_ ? -value : value;
+}
+
+[[nodiscard]] FixedPoint FixedPoint::operator-() const
+{
+    return FixedPoint{!negative_, limbs_};
+}
+
+[[nodiscard]] FixedPoint FixedPoint::add(const FixedPoint& a, const FixedPoint& b, const bool negate_b)
+{
+    const int fraction_limbs = std::max(a.fraction_limbs(), b.fraction_limbs());
+    const FixedPoint lhs = a.with_fraction_limbs(fraction_limbs);
+    const FixedPoint rhs = b.with_fraction_limbs(fraction_limbs);
+    const bool rhs_negative = rhs.negative_ != negate_b;
+
+    std::vector<std::uint32_t> limbs(lhs.limbs_.size());
+
+    if (lhs.negative_ == rhs_negative) {
+        std::uint64_t carry = 0;
+
+        for (int i = fraction_limbs; i >= 0; --i) {
+            const auto k = static_cast<std::size_t>(i);
+            const std::uint64_t sum = static_cast<std::uint64_t>(lhs.limbs_[k]) + rhs.limbs_[k] + carry;
+            limbs[k] = static_cast<std::uint32_t>(sum);
+            carry = sum >> 32;
+        }
+
+        return FixedPoint{lhs.negative_, std::move(limbs)};
+    }
+
+    // different signs: subtract the smaller magnitude from the bigger one
+    const bool lhs_bigger = compare_magnitudes(lhs.limbs_, rhs.limbs_) >= 0;
+    const auto& big = lhs_bigger ? lhs.limbs_ : rhs.limbs_;
+    const auto& small = lhs_bigger ? rhs.limbs_ : lhs.limbs_;
+    std::int64_t borrow = 0;
+
+    for (int i = fraction_limbs; i >= 0; --i) {
+        const auto k = static_cast<std::size_t>(i);
+        std::int64_t difference = static_cast<std::int64_t>(big[k]) - small[k] - borrow;
+        borrow = difference < 0 ? 1 : 0;
+
+        if (difference < 0)
+            difference += static_cast<std::int64_t>(1) << 32;
+
+        limbs[k] = static_cast<std::uint32_t>(difference);
+    }
+
+    return FixedPoint{lhs_bigger ? lhs.negative_ : rhs_negative, std::move(limbs)};
+}
+
+FixedPoint operator*(const FixedPoint& a, const FixedPoint& b)
+{
+    const std::size_t na = a.limbs_.size();
+    const std::size_t nb = b.limbs_.size();
+
+    // full product, least significant limb first
+    std::vector<std::uint64_t> product(na + nb, 0);
+
+    for (std::size_t i = 0; i < na; ++i) {
+        const std::uint64_t ai = a.limbs_[na - 1 - i];
+        std::uint64_t carry = 0;
+
+        for (std::size_t j = 0; j < nb; ++j) {
+            const std::uint64_t t = ai * b.limbs_[nb - 1 - j] + product[i + j] + carry;
+            product[i + j] = t & 0xffffffff;
+            carry = t >> 32;
+        }
+
+        product[i + nb] += carry;
+    }
+
+    // the product has fraction_limbs(a) + fraction_limbs(b) fraction limbs, truncate it to the
+    // precision of the most precise operand
+    const int fraction_limbs = std::max(a.fraction_limbs(), b.fraction_limbs());
+    const std::size_t shift = static_cast<std::size_t>(a.fraction_limbs() + b.fraction_limbs() - fraction_limbs);
+
+    std::vector<std::uint32_t> limbs(static_cast<std::size_t>(fraction_limbs + 1));
+
+    for (std::size_t k = 0; k < limbs.size(); ++k)
+        limbs[limbs.size() - 1 - k] = static_cast<std::uint32_t>(product[k + shift]);
+
+    return FixedPoint{a.negative_ != b.negative_, std::move(limbs)};
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Signed arbitrary precision fixed point number with a 32 bit integer part and a variable
+// number of 32 bit fraction limbs. The result of an operation has the precision of its most
+// precise operand. Zero is never negative, and numbers compare by value regardless of their
+// number of fraction limbs.
+class FixedPoint {
+    bool negative_;
+    std::vector<std::uint32_t> limbs_;  // [0] is the integer part, followed by the fraction (most significant first)
+
+    FixedPoint(const bool negative, std::vector<std::uint32_t> limbs);
+
+    [[nodiscard]] static FixedPoint add(const FixedPoint& a, const FixedPoint& b, const bool negate_b);
+
+public:
+    static constexpr int max_fraction_limbs = 64;
+
+    FixedPoint() : FixedPoint(0.0) {}
+    FixedPoint(const double value);
+    FixedPoint(const double value, const int fraction_limbs);
+
+    [[nodiscard]] int fraction_limbs() const { return static_cast<int>(limbs_.size()) - 1; }
+    [[nodiscard]] FixedPoint with_fraction_limbs(const int fraction_limbs) const;
+
+    [[nodiscard]] double to_double() const;
+
+    [[nodiscard]] FixedPoint operator-() const;
+
+    friend FixedPoint operator+(const FixedPoint& a, const FixedPoint& b) { return add(a, b, false); }
+    friend FixedPoint operator-(const FixedPoint& a, const FixedPoint& b) { return add(a, b, true); }
+    friend FixedPoint operator*(const FixedPoint& a, const FixedPoint& b);
+
+    bool operator==(const FixedPoint& other) const;
+};
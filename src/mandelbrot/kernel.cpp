@@ -0,0 +1,98 @@
+#include "kernel.h"
+
+#include <initializer_list>
+
+#if defined(MANDELBROT_X86_64) && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+const char* kernel_name(const Kernel kernel)
+{
+    switch (kernel) {
+    case Kernel::Auto:
+        return "auto";
+    case Kernel::Scalar:
+        return "scalar";
+    case Kernel::SSE2:
+        return "sse2";
+    case Kernel::AVX2:
+        return "avx2";
+    case Kernel::AVX512:
+        return "avx512";
+    default:
+        return "unknown";
+    }
+}
+
+#if defined(MANDELBROT_X86_64) && defined(_MSC_VER)
+
+// Check CPUID feature bits and whether the OS saves the extended register state (XCR0).
+bool cpu_supports_avx2()
+{
+    int info[4];
+    __cpuid(info, 1);
+
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+
+    if (!osxsave || !avx || (_xgetbv(0) & 0x06) != 0x06)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+}
+
+bool cpu_supports_avx512()
+{
+    if (!cpu_supports_avx2() || (_xgetbv(0) & 0xe6) != 0xe6)
+        return false;
+
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 16)) != 0;
+}
+
+#elif defined(MANDELBROT_X86_64)
+
+bool cpu_supports_avx2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+bool cpu_supports_avx512()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+}
+
+#endif
+
+[[nodiscard]] bool kernel_supported(const Kernel kernel)
+{
+    switch (kernel) {
+    case Kernel::Auto:
+    case Kernel::Scalar:
+        return true;
+#ifdef MANDELBROT_X86_64
+    case Kernel::SSE2:
+        return true;  // always available on x86-64
+    case Kernel::AVX2:
+        return cpu_supports_avx2();
+    case Kernel::AVX512:
+        return cpu_supports_avx512();
+#endif
+    default:
+        return false;
+    }
+}
+
+[[nodiscard]] Kernel best_supported_kernel()
+{
+    for (const auto kernel : {Kernel::AVX512, Kernel::AVX2, Kernel::SSE2})
+        if (kernel_supported(kernel))
+            return kernel;
+
+    return Kernel::Scalar;
+}
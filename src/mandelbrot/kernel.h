@@ -0,0 +1,18 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MANDELBROT_X86_64
+#endif
+
+enum class Kernel {
+    Auto,
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512,
+};
+
+const char* kernel_name(const Kernel kernel);
+
+[[nodiscard]] bool kernel_supported(const Kernel kernel);
+[[nodiscard]] Kernel best_supported_kernel();
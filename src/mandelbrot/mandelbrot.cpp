@@ -7,59 +7,210 @@
 
 #include <SFML/Graphics/Color.hpp>
 
-void mandelbrot_calc(const ImageSize& image, const FractalSection& section, const int max_iterations,
-                     std::vector<CalculationResult>& results_per_point, const CalculationArea& area) noexcept
+#include "colorize_kernels.h"
+#include "mandelbrot_kernels.h"
+#include "perturbation.h"
+#include "subdivision.h"
+
+// Points of a row of the area, only every column_step-th column of the area is calculated.
+[[nodiscard]] int points_per_row(const CalculationArea& area, const int column_step)
 {
+    return (area.width + column_step - 1) / column_step;
+}
+
+// Rows of results and orbits of an area with a column step (or that are not consecutive in the result layout,
+// or compact results) are gathered into these buffers so that the kernels can work on consecutive points.
+struct RowBuffers {
+    std::vector<CalculationResult> results;
+    std::vector<OrbitState> orbits;
+
+    [[nodiscard]] static bool needed(const WorkerCalculate& calculate, const int x, const int count, const int column_step)
+    {
+        return column_step > 1 || calculate.results_per_point->compact() || calculate.result_layout.contiguous_points(x, x + count) < count;
+    }
+
+    void gather(const WorkerCalculate& calculate, const int x, const int y, const int count, const int column_step)
+    {
+        results.resize(static_cast<std::size_t>(count));
+        orbits.resize(static_cast<std::size_t>(count));
+
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const std::size_t point = calculate.result_layout.index(x + static_cast<int>(i) * column_step, y);
+            results[i] = calculate.results_per_point->get(point);
+
+            if (calculate.orbits_per_point)
+                orbits[i] = (*calculate.orbits_per_point)[point];
+        }
+    }
+
+    void scatter(const WorkerCalculate& calculate, const int x, const int y, const int column_step) const
+    {
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const std::size_t point = calculate.result_layout.index(x + static_cast<int>(i) * column_step, y);
+            calculate.results_per_point->set(point, results[i]);
+
+            if (calculate.orbits_per_point)
+                (*calculate.orbits_per_point)[point] = orbits[i];
+        }
+    }
+};
+
+// Calculate the area in float or double precision, the image coordinates are rounded to double.
+CalculationStatistics mandelbrot_calc_double(const WorkerCalculate& calculate, const CalculationArea& area, const int column_step) noexcept
+{
+    const ImageSize& image = calculate.image_size;
+    const FractalSection& section = calculate.fractal_section;
+
+    const double center_x = section.center_x.to_double();
+    const double center_y = section.center_y.to_double();
     const double width = section.height * (static_cast<double>(image.width) / static_cast<double>(image.height));
 
-    const double x_left   = section.center_x - width / 2.0;
-    const double x_right  = section.center_x + width / 2.0;
-    const double y_top    = section.center_y + section.height / 2.0;
-    const double y_bottom = section.center_y - section.height / 2.0;
+    const double x_left   = center_x - width / 2.0;
+    const double x_right  = center_x + width / 2.0;
+    const double y_top    = center_y + section.height / 2.0;
+    const double y_bottom = center_y - section.height / 2.0;
+
+    const auto calculate_points = calculate_points_function(calculate.kernel, calculate.precision);
+    const auto resume_points = resume_points_function(calculate.precision);
+    const int count = points_per_row(area, column_step);
+
+    // the real parts are the same for every row of the area
+    std::vector<double> x0(static_cast<std::size_t>(count));
 
-    constexpr double bailout = 20.0;
-    constexpr double bailout_squared = bailout * bailout;
-    const double log_log_bailout = std::log(std::log(bailout));
-    const double log_2 = std::log(2.0);
+    for (int i = 0; i < count; ++i)
+        x0[static_cast<std::size_t>(i)] = std::lerp(x_left, x_right, static_cast<double>(area.x + i * column_step) / static_cast<double>(image.width));
 
-    double final_magnitude = 0.0;
+    CalculationStatistics statistics{};
+    RowBuffers row;
 
-    for (int pixel_y = area.y; pixel_y < (area.y + area.height); ++pixel_y) {
+    for (int pixel_y = area.y; pixel_y < (area.y + area.height) && !calculation_canceled(calculate); ++pixel_y) {
         const double y0 = std::lerp(y_top, y_bottom, static_cast<double>(pixel_y) / static_cast<double>(image.height));
+        const bool gather = RowBuffers::needed(calculate, area.x, count, column_step);
+        CalculationResult* results = nullptr;
+        OrbitState* orbits = nullptr;
 
-        for (int pixel_x = area.x; pixel_x < (area.x + area.width); ++pixel_x) {
-            const double x0 = std::lerp(x_left, x_right, static_cast<double>(pixel_x) / static_cast<double>(image.width));
+        if (gather) {
+            row.gather(calculate, area.x, pixel_y, count, column_step);
+            results = row.results.data();
+            orbits = calculate.orbits_per_point ? row.orbits.data() : nullptr;
+        } else {
+            const std::size_t row_start = calculate.result_layout.index(area.x, pixel_y);
+            results = calculate.results_per_point->data() + row_start;
+            orbits = calculate.orbits_per_point ? &(*calculate.orbits_per_point)[row_start] : nullptr;
+        }
 
-            double x = 0.0;
-            double y = 0.0;
+        if (calculate.resume_iterations > 0)
+            statistics.iterations_saved += resume_points(x0.data(), y0, count, calculate.resume_iterations, calculate.max_iterations, results, orbits);
+        else
+            statistics.iterations_saved += calculate_points(x0.data(), y0, count, calculate.max_iterations, results, orbits);
 
-            // iteration, will be from 1 .. max_iterations once the loop is done
-            int iter = 0;
+        if (gather)
+            row.scatter(calculate, area.x, pixel_y, column_step);
+    }
 
-            while (iter < max_iterations) {
-                const double x_squared = x * x;
-                const double y_squared = y * y;
+    return statistics;
+}
 
-                if (x_squared + y_squared >= bailout_squared) {
-                    final_magnitude = std::sqrt(x_squared + y_squared);
-                    break;
-                }
+// Calculate the area in double-double precision. Only the image center needs the extra precision,
+// the offsets of the pixels from the center are small enough to be exact in double.
+CalculationStatistics mandelbrot_calc_double_double(const WorkerCalculate& calculate, const CalculationArea& area, const int column_step) noexcept
+{
+    const ImageSize& image = calculate.image_size;
+    const FractalSection& section = calculate.fractal_section;
 
-                const double xtemp = x_squared - y_squared + x0;
-                y = 2.0 * x * y + y0;
-                x = xtemp;
+    const DoubleDouble center_x = to_double_double(section.center_x);
+    const DoubleDouble center_y = to_double_double(section.center_y);
+    const double width = section.height * (static_cast<double>(image.width) / static_cast<double>(image.height));
+    const int count = points_per_row(area, column_step);
 
-                ++iter;
-            }
+    std::vector<DoubleDouble> x0(static_cast<std::size_t>(count));
+
+    for (int i = 0; i < count; ++i) {
+        const double dx = std::lerp(-width / 2.0, width / 2.0, static_cast<double>(area.x + i * column_step) / static_cast<double>(image.width));
+        x0[static_cast<std::size_t>(i)] = center_x + DoubleDouble{dx, 0.0};
+    }
+
+    RowBuffers row;
 
-            const std::size_t pixel = static_cast<std::size_t>(pixel_y * image.width + pixel_x);
+    for (int pixel_y = area.y; pixel_y < (area.y + area.height) && !calculation_canceled(calculate); ++pixel_y) {
+        const double dy = std::lerp(section.height / 2.0, -section.height / 2.0, static_cast<double>(pixel_y) / static_cast<double>(image.height));
+        if (RowBuffers::needed(calculate, area.x, count, column_step)) {
+            row.gather(calculate, area.x, pixel_y, count, column_step);
+            calculate_points_double_double(x0.data(), center_y + DoubleDouble{dy, 0.0}, count, calculate.max_iterations, row.results.data());
+            row.scatter(calculate, area.x, pixel_y, column_step);
+        } else {
+            const std::size_t row_start = calculate.result_layout.index(area.x, pixel_y);
+            calculate_points_double_double(x0.data(), center_y + DoubleDouble{dy, 0.0}, count, calculate.max_iterations, calculate.results_per_point->data() + row_start);
+        }
+    }
 
-            if (iter < max_iterations)
-                results_per_point[pixel] = CalculationResult{iter, 1.0f - std::min(1.0f, static_cast<float>((std::log(std::log(final_magnitude)) - log_log_bailout) / log_2))};
-            else
-                results_per_point[pixel] = CalculationResult{iter, 0.0};
+    return CalculationStatistics{};
+}
+
+CalculationStatistics mandelbrot_calc_area(const WorkerCalculate& calculate, const CalculationArea& area, const int column_step) noexcept
+{
+    CalculationStatistics statistics{};
+
+    switch (calculate.precision) {
+    case Precision::DoubleDouble:
+        statistics = mandelbrot_calc_double_double(calculate, area, column_step);
+        break;
+    case Precision::Perturbation:
+        if (calculate.reference_orbit) {
+            statistics = mandelbrot_calc_perturbation(calculate, area, column_step);
+            break;
         }
+        [[fallthrough]];
+    default:
+        statistics = mandelbrot_calc_double(calculate, area, column_step);
+    }
+
+    statistics.calculated_points = points_per_row(area, column_step) * area.height;
+    return statistics;
+}
+
+// First coordinate >= start with coordinate % period == offset.
+[[nodiscard]] int first_coordinate(const int start, const int period, const int offset)
+{
+    return start + (offset - start % period + period) % period;
+}
+
+// Calculate only the points whose coordinates are multiples of grid_step. If skip_coarser_grid is set,
+// the points on the grid of 2 * grid_step are already known, either from a previous progressive pass or
+// from the previous image after zooming in.
+CalculationStatistics mandelbrot_calc_grid(const WorkerCalculate& calculate) noexcept
+{
+    const CalculationArea& area = calculate.area;
+    const int step = calculate.grid_step;
+    CalculationStatistics statistics{};
+
+    for (int y = first_coordinate(area.y, step, 0); y < (area.y + area.height) && !calculation_canceled(calculate); y += step) {
+        const bool coarser_row = calculate.skip_coarser_grid && y % (2 * step) == 0;
+        const int column_step = coarser_row ? 2 * step : step;
+        const int x = first_coordinate(area.x, column_step, coarser_row ? step : 0);
+
+        if (x >= (area.x + area.width))
+            continue;
+
+        const CalculationStatistics row_statistics = mandelbrot_calc_area(calculate, {x, y, area.x + area.width - x, 1}, column_step);
+
+        statistics.iterations_saved += row_statistics.iterations_saved;
+        statistics.rebases += row_statistics.rebases;
+        statistics.calculated_points += row_statistics.calculated_points;
     }
+
+    return statistics;
+}
+
+CalculationStatistics mandelbrot_calc(const WorkerCalculate& calculate) noexcept
+{
+    if (calculate.grid_step > 1 || calculate.skip_coarser_grid)
+        return mandelbrot_calc_grid(calculate);
+
+    if (calculate.strategy == CalculationStrategy::Subdivision && calculate.resume_iterations == 0)
+        return mandelbrot_calc_subdivision(calculate);
+
+    return mandelbrot_calc_area(calculate, calculate.area);
 }
 
 void equalize_histogram(const std::vector<int>& iterations_histogram, const int max_iterations, std::vector<float>& equalized_iterations)
@@ -83,40 +234,77 @@ void equalize_histogram(const std::vector<int>& iterations_histogram, const int
                    [=](const auto& c) { return c > 0 ? f * static_cast<float>(c - *cdf_min) : 0.0f; });
 }
 
+[[nodiscard]] float gradient_position(const CalculationResult& point, const int max_iterations, const std::vector<float>& equalized_iterations) noexcept
+{
+    // points inside the Mandelbrot Set are always painted black
+    if (point.iter == max_iterations)
+        return inside_set_gradient_position;
+
+    // The equalized iteration value (in the range of 0 .. max_iterations) represents the
+    // position of the pixel color in the color gradiant and needs to be mapped to 0.0 .. 1.0.
+    // To achieve smooth coloring we need to edge the equalized iteration towards the next
+    // iteration, determined by the distance between the two iterations.
+    const auto iter_curr = equalized_iterations[static_cast<std::size_t>(point.iter)];
+    const auto iter_next = equalized_iterations[static_cast<std::size_t>(point.iter + 1)];
+
+    const auto smoothed_iteration = std::lerp(iter_curr, iter_next, point.distance_to_next_iteration);
+    return smoothed_iteration / static_cast<float>(max_iterations);
+}
+
+[[nodiscard]] sf::Color point_color(const CalculationResult& point, const int max_iterations, const std::vector<float>& equalized_iterations, const Gradient& gradient) noexcept
+{
+    return gradient.color_at(gradient_position(point, max_iterations, equalized_iterations));
+}
+
 void mandelbrot_colorize(WorkerColorize& colorize) noexcept
 {
-    for (int y = colorize.start_row; y < (colorize.start_row + colorize.num_rows); ++y) {
-        auto point = colorize.results_per_point->cbegin() + (y * colorize.row_width);
-
-        for (int x = 0; x < colorize.row_width; ++x) {
-            std::size_t p = static_cast<std::size_t>(4 * (y * colorize.row_width + x));
-
-            if (point->iter == colorize.max_iterations) {
-                // points inside the Mandelbrot Set are always painted black
-                (*colorize.colorization_buffer)[p++] = 0;
-                (*colorize.colorization_buffer)[p++] = 0;
-                (*colorize.colorization_buffer)[p++] = 0;
-                (*colorize.colorization_buffer)[p++] = 255;
-            } else {
-                // The equalized iteration value (in the range of 0 .. max_iterations) represents the
-                // position of the pixel color in the color gradiant and needs to be mapped to 0.0 .. 1.0.
-                // To achieve smooth coloring we need to edge the equalized iteration towards the next
-                // iteration, determined by the distance between the two iterations.
-                const auto iter_curr = (*colorize.equalized_iterations)[static_cast<std::size_t>(point->iter)];
-                const auto iter_next = (*colorize.equalized_iterations)[static_cast<std::size_t>(point->iter + 1)];
-
-                const auto smoothed_iteration = std::lerp(iter_curr, iter_next, point->distance_to_next_iteration);
-                const auto pos_in_gradient = smoothed_iteration / static_cast<float>(colorize.max_iterations);
-
-                const auto color = color_from_gradient(*colorize.gradient, pos_in_gradient);
-
-                (*colorize.colorization_buffer)[p++] = color.r;
-                (*colorize.colorization_buffer)[p++] = color.g;
-                (*colorize.colorization_buffer)[p++] = color.b;
-                (*colorize.colorization_buffer)[p++] = color.a;
+    const int end_column = colorize.start_column + colorize.num_columns;
+
+    // the pixel buffers are a ring buffer, image pixel i is at (pixel_origin + i) % buffer_size
+    const std::size_t buffer_size = colorize.gradient_positions->size();
+    const auto pixel_index = [&](const int x, const int y) {
+        const std::size_t i = colorize.pixel_origin + static_cast<std::size_t>(y * colorize.row_width + x);
+        return i < buffer_size ? i : i - buffer_size;
+    };
+
+    if (colorize.lookup_only) {
+        const auto lookup_colors = lookup_colors_function(colorize.kernel, *colorize.gradient);
+
+        // whole rows are consecutive in the buffers, up to the wrap around
+        const bool whole_rows = colorize.num_columns == colorize.row_width;
+        const int count = whole_rows ? colorize.num_rows * colorize.row_width : colorize.num_columns;
+
+        for (int y = colorize.start_row; y < (colorize.start_row + colorize.num_rows); y += whole_rows ? colorize.num_rows : 1) {
+            for (int done = 0; done < count;) {
+                const std::size_t pixels = pixel_index(colorize.start_column + done % colorize.row_width, y + done / colorize.row_width);
+                const int n = static_cast<int>(std::min(static_cast<std::size_t>(count - done), buffer_size - pixels));
+
+                lookup_colors(colorize.gradient_positions->data() + pixels, n, *colorize.gradient, colorize.colorization_buffer->data() + 4 * pixels);
+                done += n;
             }
+        }
+
+        return;
+    }
+
+    const auto colorize_points = colorize_points_function(colorize.kernel, *colorize.gradient);
+
+    // the kernels read the iterations and fractions of up to this many consecutive points at once
+    constexpr int batch_size = 256;
+    int iterations[batch_size];
+    float fractions[batch_size];
+
+    for (int y = colorize.start_row; y < (colorize.start_row + colorize.num_rows); ++y) {
+        // the pixels are row-major up to the wrap around of their buffers, the results in runs of consecutive points
+        for (int x = colorize.start_column; x < end_column;) {
+            const std::size_t pixels = pixel_index(x, y);
+            const int count = std::min({batch_size, colorize.result_layout.contiguous_points(x, end_column), static_cast<int>(buffer_size - pixels)});
+
+            colorize.results_per_point->unpack(colorize.result_layout.index(x, y), static_cast<std::size_t>(count), iterations, fractions);
+            colorize_points(iterations, fractions, count, colorize.max_iterations, *colorize.equalized_iterations, *colorize.gradient,
+                colorize.gradient_positions->data() + pixels, colorize.colorization_buffer->data() + 4 * pixels);
 
-            ++point;
+            x += count;
         }
     }
 }
@@ -2,10 +2,23 @@
 
 #include <vector>
 
+#include <SFML/Graphics/Color.hpp>
+
 #include "gradient/gradient.h"
 #include "messages/messages.h"
 
-void mandelbrot_calc(const ImageSize& image, const FractalSection& section, const int max_iterations,
-                     std::vector<CalculationResult>& results_per_point, const CalculationArea& area) noexcept;
+// Checked once per row, so that canceled tiles stop early. Their results are incomplete.
+[[nodiscard]] inline bool calculation_canceled(const WorkerCalculate& calculate) noexcept
+{
+    return calculate.current_generation && calculate.current_generation->load(std::memory_order_relaxed) != calculate.generation;
+}
+
+// Gradient position of the points inside the Mandelbrot set, outside of the gradient so that they are black.
+inline constexpr float inside_set_gradient_position = -1.0f;
+
+[[nodiscard]] CalculationStatistics mandelbrot_calc(const WorkerCalculate& calculate) noexcept;
+[[nodiscard]] CalculationStatistics mandelbrot_calc_area(const WorkerCalculate& calculate, const CalculationArea& area, const int column_step = 1) noexcept;
 void mandelbrot_colorize(WorkerColorize& colorize) noexcept;
+[[nodiscard]] float gradient_position(const CalculationResult& point, const int max_iterations, const std::vector<float>& equalized_iterations) noexcept;
+[[nodiscard]] sf::Color point_color(const CalculationResult& point, const int max_iterations, const std::vector<float>& equalized_iterations, const Gradient& gradient) noexcept;
 void equalize_histogram(const std::vector<int>& iterations_histogram, const int max_iterations, std::vector<float>& equalized_iterations);
@@ -0,0 +1,735 @@
+#include "mandelbrot_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef MANDELBROT_X86_64
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define KERNEL_TARGET(isa) __attribute__((target(isa)))
+#else
+#define KERNEL_TARGET(isa)
+#endif
+
+// Two orbit points closer than this are considered equal by the periodicity check.
+template <typename T>
+constexpr T periodicity_epsilon = T{};
+
+template <>
+constexpr double periodicity_epsilon<double> = 1e-14;
+
+template <>
+constexpr float periodicity_epsilon<float> = 1e-6f;
+
+[[nodiscard]] CalculationResult escaped_point(const int iter, const double final_magnitude) noexcept
+{
+    static const double log_log_bailout = std::log(std::log(bailout));
+    static const double log_2 = std::log(2.0);
+
+    return CalculationResult{iter, 1.0f - std::min(1.0f, static_cast<float>((std::log(std::log(final_magnitude)) - log_log_bailout) / log_2))};
+}
+
+// Points inside the main cardioid or the period-2 bulb are part of the Mandelbrot Set and never escape.
+bool inside_main_cardioid_or_period2_bulb(const double x0, const double y0) noexcept
+{
+    const double y_squared = y0 * y0;
+    const double q = (x0 - 0.25) * (x0 - 0.25) + y_squared;
+
+    if (q * (q + (x0 - 0.25)) <= 0.25 * y_squared)
+        return true;
+
+    return (x0 + 1.0) * (x0 + 1.0) + y_squared <= 0.0625;
+}
+
+// Iterate a single point from z = (x, y) after iter iterations until it escapes, turns out to be
+// periodic or reaches max_iterations. Returns the number of iterations, x and y are left at the last
+// orbit point.
+template <typename T>
+[[nodiscard]] int iterate_point(const T cx, const T cy, T& x, T& y, int iter, const int max_iterations, bool& periodic) noexcept
+{
+    // Brent-style periodicity checking: compare each orbit point with a saved one, which gets
+    // replaced whenever the number of iterations reaches the next power of two.
+    T check_x = x;
+    T check_y = y;
+    int next_check = std::max(1, 2 * iter);
+
+    periodic = false;
+
+    while (iter < max_iterations) {
+        const T x_squared = x * x;
+        const T y_squared = y * y;
+
+        if (x_squared + y_squared >= static_cast<T>(bailout_squared))
+            break;
+
+        const T xtemp = x_squared - y_squared + cx;
+        y = static_cast<T>(2) * x * y + cy;
+        x = xtemp;
+
+        ++iter;
+
+        if (std::abs(x - check_x) < periodicity_epsilon<T> && std::abs(y - check_y) < periodicity_epsilon<T>) {
+            // the orbit is periodic and will never escape
+            periodic = true;
+            break;
+        }
+
+        if (iter == next_check) {
+            check_x = x;
+            check_y = y;
+            next_check *= 2;
+        }
+    }
+
+    return iter;
+}
+
+// Convert the final state of a point into its result and, if it has not escaped, remember the last
+// orbit point so that the iteration can be resumed later. Returns the number of iterations saved by
+// detecting an interior point early.
+template <typename T>
+[[nodiscard]] std::int64_t store_point(const T x, const T y, const int iter, const bool interior, const int max_iterations, CalculationResult* result, OrbitState* orbit) noexcept
+{
+    if (interior) {
+        *result = CalculationResult{max_iterations, 0.0};
+
+        if (orbit)
+            *orbit = inside_set_orbit;
+
+        return max_iterations - iter;
+    }
+
+    if (iter < max_iterations) {
+        *result = escaped_point(iter, std::sqrt(x * x + y * y));
+    } else {
+        *result = CalculationResult{iter, 0.0};
+
+        if (orbit)
+            *orbit = OrbitState{x, y, 0};
+    }
+
+    return 0;
+}
+
+// Scalar kernel, iterating in either float or double.
+template <typename T>
+[[nodiscard]] std::int64_t calculate_points_scalar(const double* x0, const double y0, const int count, const int max_iterations, CalculationResult* results, OrbitState* orbits) noexcept
+{
+    const T cy = static_cast<T>(y0);
+    std::int64_t iterations_saved = 0;
+
+    for (int i = 0; i < count; ++i) {
+        T x = 0;
+        T y = 0;
+        bool periodic = false;
+        int iter = 0;
+
+        if (!inside_main_cardioid_or_period2_bulb(x0[i], y0))
+            iter = iterate_point(static_cast<T>(x0[i]), cy, x, y, 0, max_iterations, periodic);
+        else
+            periodic = true;
+
+        iterations_saved += store_point(x, y, iter, periodic, max_iterations, &results[i], orbits ? &orbits[i] : nullptr);
+    }
+
+    return iterations_saved;
+}
+
+// Continue the iteration of all points that have not escaped after resume_iterations.
+template <typename T>
+[[nodiscard]] std::int64_t resume_points_scalar(const double* x0, const double y0, const int count, const int resume_iterations, const int max_iterations, CalculationResult* results, OrbitState* orbits) noexcept
+{
+    const T cy = static_cast<T>(y0);
+    std::int64_t iterations_saved = 0;
+
+    for (int i = 0; i < count; ++i) {
+        if (results[i].iter != resume_iterations)
+            continue;  // escaped, nothing changes
+
+        if (std::isnan(orbits[i].x)) {
+            results[i] = CalculationResult{max_iterations, 0.0};
+            iterations_saved += max_iterations - resume_iterations;
+            continue;
+        }
+
+        T x = static_cast<T>(orbits[i].x);
+        T y = static_cast<T>(orbits[i].y);
+        bool periodic = false;
+
+        const int iter = iterate_point(static_cast<T>(x0[i]), cy, x, y, resume_iterations, max_iterations, periodic);
+        iterations_saved += store_point(x, y, iter, periodic, max_iterations, &results[i], &orbits[i]);
+    }
+
+    return iterations_saved;
+}
+
+#ifdef MANDELBROT_X86_64
+
+// Mark lanes that lie inside the main cardioid or the period-2 bulb with 1.
+template <int lanes, typename T>
+void find_interior_lanes(const double* x0, const double y0, T* interior) noexcept
+{
+    for (int lane = 0; lane < lanes; ++lane)
+        interior[lane] = inside_main_cardioid_or_period2_bulb(x0[lane], y0) ? 1 : 0;
+}
+
+// Round a group of real parts to float.
+template <int lanes>
+void convert_lanes_to_float(const double* x0, float* cx) noexcept
+{
+    for (int lane = 0; lane < lanes; ++lane)
+        cx[lane] = static_cast<float>(x0[lane]);
+}
+
+// Convert the final state of a group of lanes into results. Escaped lanes have been frozen at the
+// point of escape, so their magnitude is exactly the one the scalar kernel would have seen.
+// Lanes that have been detected as interior points are reported as max_iterations.
+template <int lanes, typename T>
+[[nodiscard]] std::int64_t store_lanes(const T* x, const T* y, const T* iterations, const T* interior, const int max_iterations, CalculationResult* results, OrbitState* orbits) noexcept
+{
+    std::int64_t iterations_saved = 0;
+
+    for (int lane = 0; lane < lanes; ++lane)
+        iterations_saved += store_point(x[lane], y[lane], static_cast<int>(iterations[lane]), interior[lane] > 0, max_iterations, &results[lane], orbits ? &orbits[lane] : nullptr);
+
+    return iterations_saved;
+}
+
+// All vector kernels evaluate the exact same sequence of IEEE operations as the scalar kernel of
+// the same precision (no FMA contraction), per lane, so the results are bit-identical. Lanes that escaped or turned
+// out to be periodic are masked out and keep their last value while the remaining lanes continue
+// iterating. Since all lanes start together the periodicity check points are shared.
+
+KERNEL_TARGET("sse2")
+[[nodiscard]] std::int64_t calculate_points_sse2_double(const double* x0, const double y0, const int count, const int max_iterations, CalculationResult* results, OrbitState* orbits) noexcept
+{
+    constexpr int lanes = 2;
+
+    const __m128d bailout_sq = _mm_set1_pd(bailout_squared);
+    const __m128d epsilon = _mm_set1_pd(periodicity_epsilon<double>);
+    const __m128d sign_bit = _mm_set1_pd(-0.0);
+    const __m128d two = _mm_set1_pd(2.0);
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d cy = _mm_set1_pd(y0);
+
+    std::int64_t iterations_saved = 0;
+    int i = 0;
+
+    for (; i + lanes <= count; i += lanes) {
+        double xs[lanes], ys[lanes], iterations[lanes], interior_lanes[lanes];
+        find_interior_lanes<lanes>(x0 + i, y0, interior_lanes);
+
+        const __m128d cx = _mm_loadu_pd(x0 + i);
+
+        __m128d x = _mm_setzero_pd();
+        __m128d y = _mm_setzero_pd();
+        __m128d check_x = _mm_setzero_pd();
+        __m128d check_y = _mm_setzero_pd();
+        __m128d iter = _mm_setzero_pd();
+        __m128d interior = _mm_cmpneq_pd(_mm_loadu_pd(interior_lanes), _mm_setzero_pd());
+        __m128d active = _mm_andnot_pd(interior, _mm_cmpeq_pd(x, x));
+        int next_check = 1;
+
+        for (int n = 0; n < max_iterations; ++n) {
+            const __m128d x_squared = _mm_mul_pd(x, x);
+            const __m128d y_squared = _mm_mul_pd(y, y);
+
+            active = _mm_andnot_pd(_mm_cmpge_pd(_mm_add_pd(x_squared, y_squared), bailout_sq), active);
+
+            if (_mm_movemask_pd(active) == 0)
+                break;
+
+            const __m128d xtemp = _mm_add_pd(_mm_sub_pd(x_squared, y_squared), cx);
+            const __m128d ytemp = _mm_add_pd(_mm_mul_pd(_mm_mul_pd(two, x), y), cy);
+
+            x = _mm_or_pd(_mm_and_pd(active, xtemp), _mm_andnot_pd(active, x));
+            y = _mm_or_pd(_mm_and_pd(active, ytemp), _mm_andnot_pd(active, y));
+            iter = _mm_add_pd(iter, _mm_and_pd(active, one));
+
+            const __m128d periodic = _mm_and_pd(active, _mm_and_pd(
+                _mm_cmplt_pd(_mm_andnot_pd(sign_bit, _mm_sub_pd(x, check_x)), epsilon),
+                _mm_cmplt_pd(_mm_andnot_pd(sign_bit, _mm_sub_pd(y, check_y)), epsilon)));
+
+            interior = _mm_or_pd(interior, periodic);
+            active = _mm_andnot_pd(periodic, active);
+
+            if (n + 1 == next_check) {
+                check_x = x;
+                check_y = y;
+                next_check *= 2;
+            }
+        }
+
+        _mm_storeu_pd(xs, x);
+        _mm_storeu_pd(ys, y);
+        _mm_storeu_pd(iterations, iter);
+        _mm_storeu_pd(interior_lanes, _mm_and_pd(interior, one));
+        iterations_saved += store_lanes<lanes>(xs, ys, iterations, interior_lanes, max_iterations, results + i, orbits ? orbits + i : nullptr);
+    }
+
+    return iterations_saved + calculate_points_scalar<double>(x0 + i, y0, count - i, max_iterations, results + i, orbits ? orbits + i : nullptr);
+}
+
+KERNEL_TARGET("avx2")
+[[nodiscard]] std::int64_t calculate_points_avx2_double(const double* x0, const double y0, const int count, const int max_iterations, CalculationResult* results, OrbitState* orbits) noexcept
+{
+    constexpr int lanes = 4;
+
+    const __m256d bailout_sq = _mm256_set1_pd(bailout_squared);
+    const __m256d epsilon = _mm256_set1_pd(periodicity_epsilon<double>);
+    const __m256d sign_bit = _mm256_set1_pd(-0.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d cy = _mm256_set1_pd(y0);
+
+    std::int64_t iterations_saved = 0;
+    int i = 0;
+
+    for (; i + lanes <= count; i += lanes) {
+        double xs[lanes], ys[lanes], iterations[lanes], interior_lanes[lanes];
+        find_interior_lanes<lanes>(x0 + i, y0, interior_lanes);
+
+        const __m256d cx = _mm256_loadu_pd(x0 + i);
+
+        __m256d x = _mm256_setzero_pd();
+        __m256d y = _mm256_setzero_pd();
+        __m256d check_x = _mm256_setzero_pd();
+        __m256d check_y = _mm256_setzero_pd();
+        __m256d iter = _mm256_setzero_pd();
+        __m256d interior = _mm256_cmp_pd(_mm256_loadu_pd(interior_lanes), _mm256_setzero_pd(), _CMP_NEQ_OQ);
+        __m256d active = _mm256_andnot_pd(interior, _mm256_cmp_pd(x, x, _CMP_EQ_OQ));
+        int next_check = 1;
+
+        for (int n = 0; n < max_iterations; ++n) {
+            const __m256d x_squared = _mm256_mul_pd(x, x);
+            const __m256d y_squared = _mm256_mul_pd(y, y);
+
+            active = _mm256_andnot_pd(_mm256_cmp_pd(_mm256_add_pd(x_squared, y_squared), bailout_sq, _CMP_GE_OQ), active);
+
+            if (_mm256_movemask_pd(active) == 0)
+                break;
+
+            const __m256d xtemp = _mm256_add_pd(_mm256_sub_pd(x_squared, y_squared), cx);
+            const __m256d ytemp = _mm256_add_pd(_mm256_mul_pd(_mm256_mul_pd(two, x), y), cy);
+
+            x = _mm256_blendv_pd(x, xtemp, active);
+            y = _mm256_blendv_pd(y, ytemp, active);
+            iter = _mm256_add_pd(iter, _mm256_and_pd(active, one));
+
+            const __m256d periodic = _mm256_and_pd(active, _mm256_and_pd(
+                _mm256_cmp_pd(_mm256_andnot_pd(sign_bit, _mm256_sub_pd(x, check_x)), epsilon, _CMP_LT_OQ),
+                _mm256_cmp_pd(_mm256_andnot_pd(sign_bit, _mm256_sub_pd(y, check_y)), epsilon, _CMP_LT_OQ)));
+
+            interior = _mm256_or_pd(interior, periodic);
+            active = _mm256_andnot_pd(periodic, active);
+
+            if (n + 1 == next_check) {
+                check_x = x;
+                check_y = y;
+                next_check *= 2;
+            }
+        }
+
+        _mm256_storeu_pd(xs, x);
+        _mm256_storeu_pd(ys, y);
+        _mm256_storeu_pd(iterations, iter);
+        _mm256_storeu_pd(interior_lanes, _mm256_and_pd(interior, one));
+        iterations_saved += store_lanes<lanes>(xs, ys, iterations, interior_lanes, max_iterations, results + i, orbits ? orbits + i : nullptr);
+    }
+
+    return iterations_saved + calculate_points_scalar<double>(x0 + i, y0, count - i, max_iterations, results + i, orbits ? orbits + i : nullptr);
+}
+
+KERNEL_TARGET("avx512f")
+[[nodiscard]] std::int64_t calculate_points_avx512_double(const double* x0, const double y0, const int count, const int max_iterations, CalculationResult* results, OrbitState* orbits) noexcept
+{
+    constexpr int lanes = 8;
+
+    const __m512d bailout_sq = _mm512_set1_pd(bailout_squared);
+    const __m512d epsilon = _mm512_set1_pd(periodicity_epsilon<double>);
+    const __m512d two = _mm512_set1_pd(2.0);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d cy = _mm512_set1_pd(y0);
+
+    std::int64_t iterations_saved = 0;
+    int i = 0;
+
+    for (; i + lanes <= count; i += lanes) {
+        double xs[lanes], ys[lanes], iterations[lanes], interior_lanes[lanes];
+        find_interior_lanes<lanes>(x0 + i, y0, interior_lanes);
+
+        const __m512d cx = _mm512_loadu_pd(x0 + i);
+
+        __m512d x = _mm512_setzero_pd();
+        __m512d y = _mm512_setzero_pd();
+        __m512d check_x = _mm512_setzero_pd();
+        __m512d check_y = _mm512_setzero_pd();
+        __m512d iter = _mm512_setzero_pd();
+        __mmask8 interior = _mm512_cmp_pd_mask(_mm512_loadu_pd(interior_lanes), _mm512_setzero_pd(), _CMP_NEQ_OQ);
+        __mmask8 active = static_cast<__mmask8>(~interior);
+        int next_check = 1;
+
+        for (int n = 0; n < max_iterations; ++n) {
+            const __m512d x_squared = _mm512_mul_pd(x, x);
+            const __m512d y_squared = _mm512_mul_pd(y, y);
+
+            active = static_cast<__mmask8>(active & ~_mm512_cmp_pd_mask(_mm512_add_pd(x_squared, y_squared), bailout_sq, _CMP_GE_OQ));
+
+            if (active == 0)
+                break;
+
+            const __m512d xtemp = _mm512_add_pd(_mm512_sub_pd(x_squared, y_squared), cx);
+            y = _mm512_mask_add_pd(y, active, _mm512_mul_pd(_mm512_mul_pd(two, x), y), cy);
+            x = _mm512_mask_mov_pd(x, active, xtemp);
+            iter = _mm512_mask_add_pd(iter, active, iter, one);
+
+            const __mmask8 periodic = static_cast<__mmask8>(active
+                & _mm512_cmp_pd_mask(_mm512_abs_pd(_mm512_sub_pd(x, check_x)), epsilon, _CMP_LT_OQ)
+                & _mm512_cmp_pd_mask(_mm512_abs_pd(_mm512_sub_pd(y, check_y)), epsilon, _CMP_LT_OQ));
+
+            interior = static_cast<__mmask8>(interior | periodic);
+            active = static_cast<__mmask8>(active & ~periodic);
+
+            if (n + 1 == next_check) {
+                check_x = x;
+                check_y = y;
+                next_check *= 2;
+            }
+        }
+
+        _mm512_storeu_pd(xs, x);
+        _mm512_storeu_pd(ys, y);
+        _mm512_storeu_pd(iterations, iter);
+        _mm512_storeu_pd(interior_lanes, _mm512_maskz_mov_pd(interior, one));
+        iterations_saved += store_lanes<lanes>(xs, ys, iterations, interior_lanes, max_iterations, results + i, orbits ? orbits + i : nullptr);
+    }
+
+    return iterations_saved + calculate_points_scalar<double>(x0 + i, y0, count - i, max_iterations, results + i, orbits ? orbits + i : nullptr);
+}
+
+
+KERNEL_TARGET("sse2")
+[[nodiscard]] std::int64_t calculate_points_sse2_float(const double* x0, const double y0, const int count, const int max_iterations, CalculationResult* results, OrbitState* orbits) noexcept
+{
+    constexpr int lanes = 4;
+
+    const __m128 bailout_sq = _mm_set1_ps(static_cast<float>(bailout_squared));
+    const __m128 epsilon = _mm_set1_ps(periodicity_epsilon<float>);
+    const __m128 sign_bit = _mm_set1_ps(-0.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 cy = _mm_set1_ps(static_cast<float>(y0));
+
+    std::int64_t iterations_saved = 0;
+    int i = 0;
+
+    for (; i + lanes <= count; i += lanes) {
+        float cxs[lanes], xs[lanes], ys[lanes], iterations[lanes], interior_lanes[lanes];
+        find_interior_lanes<lanes>(x0 + i, y0, interior_lanes);
+        convert_lanes_to_float<lanes>(x0 + i, cxs);
+
+        const __m128 cx = _mm_loadu_ps(cxs);
+
+        __m128 x = _mm_setzero_ps();
+        __m128 y = _mm_setzero_ps();
+        __m128 check_x = _mm_setzero_ps();
+        __m128 check_y = _mm_setzero_ps();
+        __m128 iter = _mm_setzero_ps();
+        __m128 interior = _mm_cmpneq_ps(_mm_loadu_ps(interior_lanes), _mm_setzero_ps());
+        __m128 active = _mm_andnot_ps(interior, _mm_cmpeq_ps(x, x));
+        int next_check = 1;
+
+        for (int n = 0; n < max_iterations; ++n) {
+            const __m128 x_squared = _mm_mul_ps(x, x);
+            const __m128 y_squared = _mm_mul_ps(y, y);
+
+            active = _mm_andnot_ps(_mm_cmpge_ps(_mm_add_ps(x_squared, y_squared), bailout_sq), active);
+
+            if (_mm_movemask_ps(active) == 0)
+                break;
+
+            const __m128 xtemp = _mm_add_ps(_mm_sub_ps(x_squared, y_squared), cx);
+            const __m128 ytemp = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(two, x), y), cy);
+
+            x = _mm_or_ps(_mm_and_ps(active, xtemp), _mm_andnot_ps(active, x));
+            y = _mm_or_ps(_mm_and_ps(active, ytemp), _mm_andnot_ps(active, y));
+            iter = _mm_add_ps(iter, _mm_and_ps(active, one));
+
+            const __m128 periodic = _mm_and_ps(active, _mm_and_ps(
+                _mm_cmplt_ps(_mm_andnot_ps(sign_bit, _mm_sub_ps(x, check_x)), epsilon),
+                _mm_cmplt_ps(_mm_andnot_ps(sign_bit, _mm_sub_ps(y, check_y)), epsilon)));
+
+            interior = _mm_or_ps(interior, periodic);
+            active = _mm_andnot_ps(periodic, active);
+
+            if (n + 1 == next_check) {
+                check_x = x;
+                check_y = y;
+                next_check *= 2;
+            }
+        }
+
+        _mm_storeu_ps(xs, x);
+        _mm_storeu_ps(ys, y);
+        _mm_storeu_ps(iterations, iter);
+        _mm_storeu_ps(interior_lanes, _mm_and_ps(interior, one));
+        iterations_saved += store_lanes<lanes>(xs, ys, iterations, interior_lanes, max_iterations, results + i, orbits ? orbits + i : nullptr);
+    }
+
+    return iterations_saved + calculate_points_scalar<float>(x0 + i, y0, count - i, max_iterations, results + i, orbits ? orbits + i : nullptr);
+}
+
+KERNEL_TARGET("avx2")
+[[nodiscard]] std::int64_t calculate_points_avx2_float(const double* x0, const double y0, const int count, const int max_iterations, CalculationResult* results, OrbitState* orbits) noexcept
+{
+    constexpr int lanes = 8;
+
+    const __m256 bailout_sq = _mm256_set1_ps(static_cast<float>(bailout_squared));
+    const __m256 epsilon = _mm256_set1_ps(periodicity_epsilon<float>);
+    const __m256 sign_bit = _mm256_set1_ps(-0.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 cy = _mm256_set1_ps(static_cast<float>(y0));
+
+    std::int64_t iterations_saved = 0;
+    int i = 0;
+
+    for (; i + lanes <= count; i += lanes) {
+        float cxs[lanes], xs[lanes], ys[lanes], iterations[lanes], interior_lanes[lanes];
+        find_interior_lanes<lanes>(x0 + i, y0, interior_lanes);
+        convert_lanes_to_float<lanes>(x0 + i, cxs);
+
+        const __m256 cx = _mm256_loadu_ps(cxs);
+
+        __m256 x = _mm256_setzero_ps();
+        __m256 y = _mm256_setzero_ps();
+        __m256 check_x = _mm256_setzero_ps();
+        __m256 check_y = _mm256_setzero_ps();
+        __m256 iter = _mm256_setzero_ps();
+        __m256 interior = _mm256_cmp_ps(_mm256_loadu_ps(interior_lanes), _mm256_setzero_ps(), _CMP_NEQ_OQ);
+        __m256 active = _mm256_andnot_ps(interior, _mm256_cmp_ps(x, x, _CMP_EQ_OQ));
+        int next_check = 1;
+
+        for (int n = 0; n < max_iterations; ++n) {
+            const __m256 x_squared = _mm256_mul_ps(x, x);
+            const __m256 y_squared = _mm256_mul_ps(y, y);
+
+            active = _mm256_andnot_ps(_mm256_cmp_ps(_mm256_add_ps(x_squared, y_squared), bailout_sq, _CMP_GE_OQ), active);
+
+            if (_mm256_movemask_ps(active) == 0)
+                break;
+
+            const __m256 xtemp = _mm256_add_ps(_mm256_sub_ps(x_squared, y_squared), cx);
+            const __m256 ytemp = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(two, x), y), cy);
+
+            x = _mm256_blendv_ps(x, xtemp, active);
+            y = _mm256_blendv_ps(y, ytemp, active);
+            iter = _mm256_add_ps(iter, _mm256_and_ps(active, one));
+
+            const __m256 periodic = _mm256_and_ps(active, _mm256_and_ps(
+                _mm256_cmp_ps(_mm256_andnot_ps(sign_bit, _mm256_sub_ps(x, check_x)), epsilon, _CMP_LT_OQ),
+                _mm256_cmp_ps(_mm256_andnot_ps(sign_bit, _mm256_sub_ps(y, check_y)), epsilon, _CMP_LT_OQ)));
+
+            interior = _mm256_or_ps(interior, periodic);
+            active = _mm256_andnot_ps(periodic, active);
+
+            if (n + 1 == next_check) {
+                check_x = x;
+                check_y = y;
+                next_check *= 2;
+            }
+        }
+
+        _mm256_storeu_ps(xs, x);
+        _mm256_storeu_ps(ys, y);
+        _mm256_storeu_ps(iterations, iter);
+        _mm256_storeu_ps(interior_lanes, _mm256_and_ps(interior, one));
+        iterations_saved += store_lanes<lanes>(xs, ys, iterations, interior_lanes, max_iterations, results + i, orbits ? orbits + i : nullptr);
+    }
+
+    return iterations_saved + calculate_points_scalar<float>(x0 + i, y0, count - i, max_iterations, results + i, orbits ? orbits + i : nullptr);
+}
+
+KERNEL_TARGET("avx512f")
+[[nodiscard]] std::int64_t calculate_points_avx512_float(const double* x0, const double y0, const int count, const int max_iterations, CalculationResult* results, OrbitState* orbits) noexcept
+{
+    constexpr int lanes = 16;
+
+    const __m512 bailout_sq = _mm512_set1_ps(static_cast<float>(bailout_squared));
+    const __m512 epsilon = _mm512_set1_ps(periodicity_epsilon<float>);
+    const __m512 two = _mm512_set1_ps(2.0f);
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 cy = _mm512_set1_ps(static_cast<float>(y0));
+
+    std::int64_t iterations_saved = 0;
+    int i = 0;
+
+    for (; i + lanes <= count; i += lanes) {
+        float cxs[lanes], xs[lanes], ys[lanes], iterations[lanes], interior_lanes[lanes];
+        find_interior_lanes<lanes>(x0 + i, y0, interior_lanes);
+        convert_lanes_to_float<lanes>(x0 + i, cxs);
+
+        const __m512 cx = _mm512_loadu_ps(cxs);
+
+        __m512 x = _mm512_setzero_ps();
+        __m512 y = _mm512_setzero_ps();
+        __m512 check_x = _mm512_setzero_ps();
+        __m512 check_y = _mm512_setzero_ps();
+        __m512 iter = _mm512_setzero_ps();
+        __mmask16 interior = _mm512_cmp_ps_mask(_mm512_loadu_ps(interior_lanes), _mm512_setzero_ps(), _CMP_NEQ_OQ);
+        __mmask16 active = static_cast<__mmask16>(~interior);
+        int next_check = 1;
+
+        for (int n = 0; n < max_iterations; ++n) {
+            const __m512 x_squared = _mm512_mul_ps(x, x);
+            const __m512 y_squared = _mm512_mul_ps(y, y);
+
+            active = static_cast<__mmask16>(active & ~_mm512_cmp_ps_mask(_mm512_add_ps(x_squared, y_squared), bailout_sq, _CMP_GE_OQ));
+
+            if (active == 0)
+                break;
+
+            const __m512 xtemp = _mm512_add_ps(_mm512_sub_ps(x_squared, y_squared), cx);
+            y = _mm512_mask_add_ps(y, active, _mm512_mul_ps(_mm512_mul_ps(two, x), y), cy);
+            x = _mm512_mask_mov_ps(x, active, xtemp);
+            iter = _mm512_mask_add_ps(iter, active, iter, one);
+
+            const __mmask16 periodic = static_cast<__mmask16>(active
+                & _mm512_cmp_ps_mask(_mm512_abs_ps(_mm512_sub_ps(x, check_x)), epsilon, _CMP_LT_OQ)
+                & _mm512_cmp_ps_mask(_mm512_abs_ps(_mm512_sub_ps(y, check_y)), epsilon, _CMP_LT_OQ));
+
+            interior = static_cast<__mmask16>(interior | periodic);
+            active = static_cast<__mmask16>(active & ~periodic);
+
+            if (n + 1 == next_check) {
+                check_x = x;
+                check_y = y;
+                next_check *= 2;
+            }
+        }
+
+        _mm512_storeu_ps(xs, x);
+        _mm512_storeu_ps(ys, y);
+        _mm512_storeu_ps(iterations, iter);
+        _mm512_storeu_ps(interior_lanes, _mm512_maskz_mov_ps(interior, one));
+        iterations_saved += store_lanes<lanes>(xs, ys, iterations, interior_lanes, max_iterations, results + i, orbits ? orbits + i : nullptr);
+    }
+
+    return iterations_saved + calculate_points_scalar<float>(x0 + i, y0, count - i, max_iterations, results + i, orbits ? orbits + i : nullptr);
+}
+
+#endif
+
+// ---- double-double -----------------
+// The error-free transformations rely on the absence of FMA contraction in this file.
+
+[[nodiscard]] DoubleDouble to_double_double(const FixedPoint& value)
+{
+    const double hi = value.to_double();
+    return DoubleDouble{hi, (value - FixedPoint{hi}).to_double()};
+}
+
+DoubleDouble two_sum(const double a, const double b) noexcept
+{
+    const double s = a + b;
+    const double bb = s - a;
+    return DoubleDouble{s, (a - (s - bb)) + (b - bb)};
+}
+
+DoubleDouble quick_two_sum(const double a, const double b) noexcept
+{
+    const double s = a + b;
+    return DoubleDouble{s, b - (s - a)};
+}
+
+// Dekker's product, exact without FMA.
+DoubleDouble two_prod(const double a, const double b) noexcept
+{
+    constexpr double splitter = 134217729.0;  // 2^27 + 1
+
+    const double p = a * b;
+    const double ta = splitter * a;
+    const double tb = splitter * b;
+    const double a_hi = ta - (ta - a);
+    const double b_hi = tb - (tb - b);
+    const double a_lo = a - a_hi;
+    const double b_lo = b - b_hi;
+
+    return DoubleDouble{p, ((a_hi * b_hi - p) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo};
+}
+
+DoubleDouble operator+(const DoubleDouble& a, const DoubleDouble& b) noexcept
+{
+    const DoubleDouble s = two_sum(a.hi, b.hi);
+    return quick_two_sum(s.hi, s.lo + a.lo + b.lo);
+}
+
+DoubleDouble operator-(const DoubleDouble& a, const DoubleDouble& b) noexcept
+{
+    return a + DoubleDouble{-b.hi, -b.lo};
+}
+
+DoubleDouble operator*(const DoubleDouble& a, const DoubleDouble& b) noexcept
+{
+    const DoubleDouble p = two_prod(a.hi, b.hi);
+    return quick_two_sum(p.hi, p.lo + (a.hi * b.lo + a.lo * b.hi));
+}
+
+// Double-double kernel, used for zoom levels between double precision and perturbation.
+// Interior detection is disabled because it would have to be evaluated in double-double as well.
+void calculate_points_double_double(const DoubleDouble* x0, const DoubleDouble y0, const int count, const int max_iterations, CalculationResult* results) noexcept
+{
+    for (int i = 0; i < count; ++i) {
+        DoubleDouble x{0.0, 0.0};
+        DoubleDouble y{0.0, 0.0};
+        double final_magnitude = 0.0;
+        int iter = 0;
+
+        while (iter < max_iterations) {
+            const DoubleDouble x_squared = x * x;
+            const DoubleDouble y_squared = y * y;
+
+            if (x_squared.hi + y_squared.hi >= bailout_squared) {
+                final_magnitude = std::sqrt(x_squared.hi + y_squared.hi);
+                break;
+            }
+
+            const DoubleDouble xy = x * y;
+            const DoubleDouble xtemp = x_squared - y_squared + x0[i];
+            y = xy + xy + y0;
+            x = xtemp;
+
+            ++iter;
+        }
+
+        if (iter < max_iterations)
+            results[i] = escaped_point(iter, final_magnitude);
+        else
+            results[i] = CalculationResult{iter, 0.0};
+    }
+}
+
+[[nodiscard]] CalculatePointsFunction calculate_points_function(const Kernel kernel, const Precision precision) noexcept
+{
+    const bool use_float = precision == Precision::Float;
+
+    switch (kernel) {
+#ifdef MANDELBROT_X86_64
+    case Kernel::SSE2:
+        return use_float ? calculate_points_sse2_float : calculate_points_sse2_double;
+    case Kernel::AVX2:
+        return use_float ? calculate_points_avx2_float : calculate_points_avx2_double;
+    case Kernel::AVX512:
+        return use_float ? calculate_points_avx512_float : calculate_points_avx512_double;
+#endif
+    default:
+        return use_float ? calculate_points_scalar<float> : calculate_points_scalar<double>;
+    }
+}
+
+[[nodiscard]] ResumePointsFunction resume_points_function(const Precision precision) noexcept
+{
+    return precision == Precision::Float ? resume_points_scalar<float> : resume_points_scalar<double>;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "kernel.h"
+#include "precision.h"
+#include "messages/messages.h"
+
+inline constexpr double bailout = 20.0;
+inline constexpr double bailout_squared = bailout * bailout;
+
+// Orbit state of points that are known to be inside the Mandelbrot set.
+inline constexpr OrbitState inside_set_orbit{std::numeric_limits<double>::quiet_NaN(), 0.0, 0};
+
+// Smooth coloring information of a point that escaped after iter iterations.
+[[nodiscard]] CalculationResult escaped_point(const int iter, const double final_magnitude) noexcept;
+
+// Calculate a row of count points with the real parts x0[0 .. count-1] and the imaginary part y0.
+// If orbits is not null the last orbit point of every point that did not escape is stored there.
+// Returns the number of iterations that have been skipped by detecting interior points early.
+using CalculatePointsFunction = std::int64_t (*)(const double* x0, const double y0, const int count, const int max_iterations, CalculationResult* results, OrbitState* orbits) noexcept;
+
+// Continue the calculation of a row of points that did not escape after resume_iterations up to
+// max_iterations, starting from their stored orbit points.
+using ResumePointsFunction = std::int64_t (*)(const double* x0, const double y0, const int count, const int resume_iterations, const int max_iterations, CalculationResult* results, OrbitState* orbits) noexcept;
+
+// Float or double kernel for the given instruction set.
+[[nodiscard]] CalculatePointsFunction calculate_points_function(const Kernel kernel, const Precision precision) noexcept;
+
+// Float or double kernel that resumes points, scalar for every instruction set.
+[[nodiscard]] ResumePointsFunction resume_points_function(const Precision precision) noexcept;
+
+// Unevaluated sum of two doubles with about 106 bits of precision.
+struct DoubleDouble {
+    double hi, lo;
+};
+
+[[nodiscard]] DoubleDouble to_double_double(const FixedPoint& value);
+[[nodiscard]] DoubleDouble operator+(const DoubleDouble& a, const DoubleDouble& b) noexcept;
+
+void calculate_points_double_double(const DoubleDouble* x0, const DoubleDouble y0, const int count, const int max_iterations, CalculationResult* results) noexcept;
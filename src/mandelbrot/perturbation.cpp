@@ -0,0 +1,142 @@
+#include "perturbation.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "mandelbrot.h"
+#include "mandelbrot_kernels.h"
+
+[[nodiscard]] int required_fraction_limbs(const ImageSize& image_size, const FractalSection& fractal_section)
+{
+    // enough bits to resolve a single pixel plus 64 guard bits
+    const double pixel_spacing = fractal_section.height / static_cast<double>(image_size.height);
+    const int bits = static_cast<int>(std::ceil(-std::log2(pixel_spacing))) + 64;
+
+    return std::clamp((bits + 31) / 32, 2, FixedPoint::max_fraction_limbs);
+}
+
+[[nodiscard]] ReferenceOrbit calculate_reference_orbit(const FractalSection& fractal_section, const int max_iterations, const int fraction_limbs)
+{
+    ReferenceOrbit reference{fractal_section.center_x, fractal_section.center_y, max_iterations, fraction_limbs, {}, {}};
+
+    const FixedPoint cx = fractal_section.center_x.with_fraction_limbs(std::max(fraction_limbs, fractal_section.center_x.fraction_limbs()));
+    const FixedPoint cy = fractal_section.center_y.with_fraction_limbs(std::max(fraction_limbs, fractal_section.center_y.fraction_limbs()));
+
+    FixedPoint x{0.0, fraction_limbs};
+    FixedPoint y{0.0, fraction_limbs};
+
+    reference.x.reserve(static_cast<std::size_t>(max_iterations + 1));
+    reference.y.reserve(static_cast<std::size_t>(max_iterations + 1));
+    reference.x.push_back(0.0);
+    reference.y.push_back(0.0);
+
+    for (int iter = 0; iter < max_iterations; ++iter) {
+        if (reference.x.back() * reference.x.back() + reference.y.back() * reference.y.back() >= bailout_squared)
+            break;
+
+        const FixedPoint xy = x * y;
+        const FixedPoint xtemp = x * x - y * y + cx;
+        y = xy + xy + cy;
+        x = xtemp;
+
+        reference.x.push_back(x.to_double());
+        reference.y.push_back(y.to_double());
+    }
+
+    return reference;
+}
+
+// Iterate each point as the delta dz against the reference orbit Z, with z = Z + dz and
+// c = C + dc: dz' = 2 * Z * dz + dz^2 + dc. Glitches (where the delta grows bigger than the
+// full value and loses precision) are avoided by rebasing: the delta is reset to the full value z
+// and iteration continues from the start of the reference orbit. The same happens when the end
+// of the reference orbit is reached because the reference point escaped.
+// A point that did not escape keeps its delta and position in the reference orbit, so that it
+// can be resumed exactly where it stopped (the reference orbit only grows with max_iterations).
+[[nodiscard]] CalculationStatistics mandelbrot_calc_perturbation(const WorkerCalculate& calculate, const CalculationArea& area, const int column_step) noexcept
+{
+    const ReferenceOrbit& reference = *calculate.reference_orbit;
+    const ImageSize& image = calculate.image_size;
+    const FractalSection& section = calculate.fractal_section;
+    const int max_iterations = calculate.max_iterations;
+
+    assert(reference.center_x == section.center_x && reference.center_y == section.center_y);
+
+    const double width = section.height * (static_cast<double>(image.width) / static_cast<double>(image.height));
+    const auto last = static_cast<std::size_t>(reference.x.size() - 1);
+
+    CalculationStatistics statistics{};
+
+    // the real parts of the deltas are the same for every row of the area
+    // (only every column_step-th column of the area is calculated)
+    const int count = (area.width + column_step - 1) / column_step;
+    std::vector<double> dcx(static_cast<std::size_t>(count));
+
+    for (int i = 0; i < count; ++i)
+        dcx[static_cast<std::size_t>(i)] = std::lerp(-width / 2.0, width / 2.0, static_cast<double>(area.x + i * column_step) / static_cast<double>(image.width));
+
+    CalculationResults& results = *calculate.results_per_point;
+    OrbitState* orbits = calculate.orbits_per_point ? calculate.orbits_per_point->data() : nullptr;
+
+    for (int pixel_y = area.y; pixel_y < (area.y + area.height) && !calculation_canceled(calculate); ++pixel_y) {
+        const double dcy = std::lerp(section.height / 2.0, -section.height / 2.0, static_cast<double>(pixel_y) / static_cast<double>(image.height));
+
+        for (int i = 0; i < count; ++i) {
+            const std::size_t p = calculate.result_layout.index(area.x + i * column_step, pixel_y);
+            double dx = 0.0;
+            double dy = 0.0;
+            double final_magnitude = 0.0;
+            std::size_t m = 0;  // position in the reference orbit
+            int iter = 0;
+
+            if (calculate.resume_iterations > 0) {
+                if (results.iter(p) != calculate.resume_iterations)
+                    continue;  // escaped, nothing changes
+
+                dx = orbits[p].x;
+                dy = orbits[p].y;
+                m = static_cast<std::size_t>(orbits[p].reference_index);
+                iter = calculate.resume_iterations;
+            }
+
+            while (iter < max_iterations) {
+                const double x = reference.x[m] + dx;
+                const double y = reference.y[m] + dy;
+                const double magnitude_squared = x * x + y * y;
+
+                if (magnitude_squared >= bailout_squared) {
+                    final_magnitude = std::sqrt(magnitude_squared);
+                    break;
+                }
+
+                if (magnitude_squared < dx * dx + dy * dy || m == last) {
+                    dx = x;
+                    dy = y;
+                    m = 0;
+                    ++statistics.rebases;
+                }
+
+                const double zx = reference.x[m];
+                const double zy = reference.y[m];
+                const double dxtemp = 2.0 * (zx * dx - zy * dy) + (dx * dx - dy * dy) + dcx[static_cast<std::size_t>(i)];
+                dy = 2.0 * (zx * dy + zy * dx) + 2.0 * dx * dy + dcy;
+                dx = dxtemp;
+
+                ++m;
+                ++iter;
+            }
+
+            if (iter < max_iterations) {
+                results.set(p, escaped_point(iter, final_magnitude));
+            } else {
+                results.set(p, CalculationResult{iter, 0.0});
+
+                if (orbits)
+                    orbits[p] = OrbitState{dx, dy, static_cast<int>(m)};
+            }
+        }
+    }
+
+    return statistics;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <vector>
+
+#include "fixed_point.h"
+#include "messages/messages.h"
+
+// Orbit of the reference point in the center of the image, calculated with arbitrary precision
+// and rounded to double. Every pixel gets iterated as a small double delta against this orbit.
+struct ReferenceOrbit {
+    FixedPoint center_x, center_y;
+    int max_iterations;
+    int fraction_limbs;
+    std::vector<double> x, y;
+};
+
+[[nodiscard]] int required_fraction_limbs(const ImageSize& image_size, const FractalSection& fractal_section);
+
+[[nodiscard]] ReferenceOrbit calculate_reference_orbit(const FractalSection& fractal_section, const int max_iterations, const int fraction_limbs);
+[[nodiscard]] CalculationStatistics mandelbrot_calc_perturbation(const WorkerCalculate& calculate, const CalculationArea& area, const int column_step) noexcept;
@@ -0,0 +1,60 @@
+#include "precision.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <fmt/core.h>
+
+#include "messages/messages.h"
+
+// A number type is accurate enough as long as the pixel spacing stays well above the
+// rounding error of the image coordinates. For float the rounding errors of the iterations
+// themselves add up as well, at least in proportion to max_iterations, so it is only chosen
+// for few iterations.
+constexpr double safety_factor = 1000.0;
+constexpr double float_epsilon = std::numeric_limits<float>::epsilon();
+constexpr double double_epsilon = std::numeric_limits<double>::epsilon();
+constexpr double double_double_epsilon = double_epsilon * double_epsilon;
+
+const char* precision_name(const Precision precision)
+{
+    switch (precision) {
+    case Precision::Float:
+        return "float";
+    case Precision::Double:
+        return "double";
+    case Precision::DoubleDouble:
+        return "double-double";
+    case Precision::Perturbation:
+        return "perturbation";
+    default:
+        return "unknown";
+    }
+}
+
+[[nodiscard]] PrecisionChoice choose_precision(const ImageSize& image_size, const FractalSection& fractal_section, const int max_iterations)
+{
+    const double pixel_spacing = fractal_section.height / static_cast<double>(image_size.height);
+    const double magnitude = std::max({1.0, std::abs(fractal_section.center_x.to_double()), std::abs(fractal_section.center_y.to_double())});
+
+    const double float_limit = safety_factor * float_epsilon * magnitude * static_cast<double>(max_iterations);
+    const double double_limit = safety_factor * double_epsilon * magnitude;
+    const double double_double_limit = safety_factor * double_double_epsilon * magnitude;
+
+    if (pixel_spacing >= float_limit)
+        return {Precision::Float, fmt::format("pixel spacing {:.2e} >= float limit {:.2e} at {} iterations", pixel_spacing, float_limit, max_iterations)};
+
+    if (pixel_spacing >= double_limit)
+        return {Precision::Double, fmt::format("pixel spacing {:.2e} < float limit {:.2e} at {} iterations", pixel_spacing, float_limit, max_iterations)};
+
+    if (pixel_spacing >= double_double_limit)
+        return {Precision::DoubleDouble, fmt::format("pixel spacing {:.2e} < double limit {:.2e}", pixel_spacing, double_limit)};
+
+    return {Precision::Perturbation, fmt::format("pixel spacing {:.2e} < double-double limit {:.2e}", pixel_spacing, double_double_limit)};
+}
+
+[[nodiscard]] double min_fractal_height(const ImageSize& image_size)
+{
+    return safety_factor * std::numeric_limits<double>::min() * static_cast<double>(image_size.height);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+struct FractalSection;
+struct ImageSize;
+
+enum class Precision {
+    Float,
+    Double,
+    DoubleDouble,
+    Perturbation,
+};
+
+struct PrecisionChoice {
+    Precision precision;
+    std::string reason;
+};
+
+const char* precision_name(const Precision precision);
+
+[[nodiscard]] PrecisionChoice choose_precision(const ImageSize& image_size, const FractalSection& fractal_section, const int max_iterations);
+
+// The pixel spacing, FractalSection::height and the deltas of perturbation are plain doubles, which keep their
+// full precision only down to about 1e-308. The fractal height must not become smaller than this.
+[[nodiscard]] double min_fractal_height(const ImageSize& image_size);
@@ -0,0 +1,15 @@
+#include "strategy.h"
+
+const char* calculation_strategy_name(const CalculationStrategy strategy)
+{
+    switch (strategy) {
+    case CalculationStrategy::Full:
+        return "full";
+    case CalculationStrategy::Subdivision:
+        return "subdivision";
+    case CalculationStrategy::Progressive:
+        return "progressive";
+    default:
+        return "unknown";
+    }
+}
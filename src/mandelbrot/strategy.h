@@ -0,0 +1,9 @@
+#pragma once
+
+enum class CalculationStrategy {
+    Full,
+    Subdivision,
+    Progressive,
+};
+
+const char* calculation_strategy_name(const CalculationStrategy strategy);
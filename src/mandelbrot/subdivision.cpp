@@ -0,0 +1,114 @@
+#include "subdivision.h"
+
+#include <cmath>
+
+#include "mandelbrot.h"
+
+// Rectangles whose interior is smaller than this are calculated completely instead of being split further.
+constexpr int min_subdivision_size = 4;
+
+void add_statistics(CalculationStatistics& statistics, const CalculationStatistics& other)
+{
+    statistics.iterations_saved += other.iterations_saved;
+    statistics.rebases += other.rebases;
+    statistics.calculated_points += other.calculated_points;
+    statistics.filled_points += other.filled_points;
+}
+
+[[nodiscard]] CalculationResult result_at(const WorkerCalculate& calculate, const int x, const int y)
+{
+    return calculate.results_per_point->get(calculate.result_layout.index(x, y));
+}
+
+void set_result_at(const WorkerCalculate& calculate, const int x, const int y, const CalculationResult& result)
+{
+    calculate.results_per_point->set(calculate.result_layout.index(x, y), result);
+}
+
+[[nodiscard]] bool border_is_uniform(const WorkerCalculate& calculate, const CalculationArea& area)
+{
+    const int iter = result_at(calculate, area.x, area.y).iter;
+
+    for (int x = area.x; x < (area.x + area.width); ++x)
+        if (result_at(calculate, x, area.y).iter != iter || result_at(calculate, x, area.y + area.height - 1).iter != iter)
+            return false;
+
+    for (int y = area.y + 1; y < (area.y + area.height - 1); ++y)
+        if (result_at(calculate, area.x, y).iter != iter || result_at(calculate, area.x + area.width - 1, y).iter != iter)
+            return false;
+
+    return true;
+}
+
+// Fill the interior of a rectangle with the iteration count of its border. The fractional part used
+// for smooth coloring is interpolated between the left and right border of each row.
+void fill_interior(const WorkerCalculate& calculate, const CalculationArea& area)
+{
+    const int right = area.x + area.width - 1;
+
+    for (int y = area.y + 1; y < (area.y + area.height - 1); ++y) {
+        const CalculationResult left_border = result_at(calculate, area.x, y);
+        const CalculationResult right_border = result_at(calculate, right, y);
+
+        for (int x = area.x + 1; x < right; ++x) {
+            const float t = static_cast<float>(x - area.x) / static_cast<float>(area.width - 1);
+            set_result_at(calculate, x, y, CalculationResult{left_border.iter, std::lerp(left_border.distance_to_next_iteration, right_border.distance_to_next_iteration, t)});
+        }
+    }
+}
+
+// The border of area has already been calculated. If all border points have the same iteration
+// count, so have all points inside (the Mandelbrot set and the iteration bands around it are
+// connected). Otherwise the rectangle is split in half along its longer side.
+void subdivide(const WorkerCalculate& calculate, const CalculationArea& area, CalculationStatistics& statistics)
+{
+    const CalculationArea interior{area.x + 1, area.y + 1, area.width - 2, area.height - 2};
+
+    if (interior.width <= 0 || interior.height <= 0 || calculation_canceled(calculate))
+        return;
+
+    if (border_is_uniform(calculate, area)) {
+        fill_interior(calculate, area);
+        statistics.filled_points += interior.width * interior.height;
+        return;
+    }
+
+    if (interior.width < min_subdivision_size || interior.height < min_subdivision_size) {
+        add_statistics(statistics, mandelbrot_calc_area(calculate, interior));
+        return;
+    }
+
+    if (area.width >= area.height) {
+        const int split_x = area.x + area.width / 2;
+
+        add_statistics(statistics, mandelbrot_calc_area(calculate, {split_x, interior.y, 1, interior.height}));
+        subdivide(calculate, {area.x, area.y, split_x - area.x + 1, area.height}, statistics);
+        subdivide(calculate, {split_x, area.y, area.x + area.width - split_x, area.height}, statistics);
+    } else {
+        const int split_y = area.y + area.height / 2;
+
+        add_statistics(statistics, mandelbrot_calc_area(calculate, {interior.x, split_y, interior.width, 1}));
+        subdivide(calculate, {area.x, area.y, area.width, split_y - area.y + 1}, statistics);
+        subdivide(calculate, {area.x, split_y, area.width, area.y + area.height - split_y}, statistics);
+    }
+}
+
+// Mariani-Silver algorithm: calculate the border of the area and fill or subdivide its interior.
+[[nodiscard]] CalculationStatistics mandelbrot_calc_subdivision(const WorkerCalculate& calculate) noexcept
+{
+    const CalculationArea& area = calculate.area;
+
+    if (area.width <= 2 || area.height <= 2)
+        return mandelbrot_calc_area(calculate, area);
+
+    CalculationStatistics statistics{};
+
+    add_statistics(statistics, mandelbrot_calc_area(calculate, {area.x, area.y, area.width, 1}));
+    add_statistics(statistics, mandelbrot_calc_area(calculate, {area.x, area.y + area.height - 1, area.width, 1}));
+    add_statistics(statistics, mandelbrot_calc_area(calculate, {area.x, area.y + 1, 1, area.height - 2}));
+    add_statistics(statistics, mandelbrot_calc_area(calculate, {area.x + area.width - 1, area.y + 1, 1, area.height - 2}));
+
+    subdivide(calculate, area, statistics);
+
+    return statistics;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "messages/messages.h"
+
+[[nodiscard]] CalculationStatistics mandelbrot_calc_subdivision(const WorkerCalculate& calculate) noexcept;
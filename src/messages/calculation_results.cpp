@@ -0,0 +1,129 @@
+#include "calculation_results.h"
+
+#include <limits>
+#include <utility>
+
+CalculationResults::CalculationResults(const std::size_t size, const bool compact, const int max_iterations) :
+    compact_{compact}, iteration_bits_{iteration_bits_for(max_iterations)}, size_{size}
+{
+    if (!compact_) {
+        points_ = Plane<CalculationResult>(size_);
+        return;
+    }
+
+    allocate_iterations();
+    fractions_ = Plane<std::uint16_t>(size_);
+}
+
+[[nodiscard]] int CalculationResults::iteration_bits_for(const int max_iterations)
+{
+    if (max_iterations <= std::numeric_limits<std::uint8_t>::max())
+        return 8;
+
+    if (max_iterations <= std::numeric_limits<std::uint16_t>::max())
+        return 16;
+
+    return 32;
+}
+
+void CalculationResults::allocate_iterations()
+{
+    switch (iteration_bits_) {
+    case 8:
+        iterations8_ = Plane<std::uint8_t>(size_);
+        break;
+    case 16:
+        iterations16_ = Plane<std::uint16_t>(size_);
+        break;
+    default:
+        iterations32_ = Plane<std::uint32_t>(size_);
+    }
+}
+
+void CalculationResults::unpack(const std::size_t begin, const std::size_t count, int* iterations, float* fractions) const noexcept
+{
+    if (!compact_) {
+        for (std::size_t i = 0; i < count; ++i) {
+            iterations[i] = points_[begin + i].iter;
+            fractions[i] = points_[begin + i].distance_to_next_iteration;
+        }
+
+        return;
+    }
+
+    switch (iteration_bits_) {
+    case 8:
+        std::copy_n(iterations8_.begin() + static_cast<std::ptrdiff_t>(begin), count, iterations);
+        break;
+    case 16:
+        std::copy_n(iterations16_.begin() + static_cast<std::ptrdiff_t>(begin), count, iterations);
+        break;
+    default:
+        std::copy_n(iterations32_.begin() + static_cast<std::ptrdiff_t>(begin), count, iterations);
+    }
+
+    // the same conversion as get()
+    for (std::size_t i = 0; i < count; ++i)
+        fractions[i] = static_cast<float>(fractions_[begin + i]) / fraction_scale;
+}
+
+void CalculationResults::zero(const std::size_t begin, const std::size_t end)
+{
+    const auto first = static_cast<std::ptrdiff_t>(begin);
+    const auto last = static_cast<std::ptrdiff_t>(end);
+
+    if (!compact_) {
+        std::fill(points_.begin() + first, points_.begin() + last, CalculationResult{});
+        return;
+    }
+
+    switch (iteration_bits_) {
+    case 8:
+        std::fill(iterations8_.begin() + first, iterations8_.begin() + last, std::uint8_t{0});
+        break;
+    case 16:
+        std::fill(iterations16_.begin() + first, iterations16_.begin() + last, std::uint16_t{0});
+        break;
+    default:
+        std::fill(iterations32_.begin() + first, iterations32_.begin() + last, std::uint32_t{0});
+    }
+
+    std::fill(fractions_.begin() + first, fractions_.begin() + last, std::uint16_t{0});
+}
+
+bool CalculationResults::reserve_iterations(const int max_iterations)
+{
+    const int bits = iteration_bits_for(max_iterations);
+
+    if (!compact_ || bits <= iteration_bits_)
+        return false;
+
+    // the points keep their iterations, so that the calculation can be resumed (only 8 or 16 bits can be widened)
+    narrow_iteration_bits_ = iteration_bits_;
+    narrow_iterations8_ = std::move(iterations8_);
+    narrow_iterations16_ = std::move(iterations16_);
+
+    iteration_bits_ = bits;
+    allocate_iterations();
+
+    return true;
+}
+
+void CalculationResults::widen_iterations(const std::size_t begin, const std::size_t end)
+{
+    for (std::size_t i = begin; i < end; ++i) {
+        const int value = narrow_iteration_bits_ == 8 ? narrow_iterations8_[i] : narrow_iterations16_[i];
+
+        if (iteration_bits_ == 16)
+            iterations16_[i] = static_cast<std::uint16_t>(value);
+        else
+            iterations32_[i] = static_cast<std::uint32_t>(value);
+    }
+}
+
+void CalculationResults::finish_widening()
+{
+    narrow_iteration_bits_ = 0;
+    narrow_iterations8_ = Plane<std::uint8_t>{};
+    narrow_iterations16_ = Plane<std::uint16_t>{};
+}
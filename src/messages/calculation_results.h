@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "default_init_allocator.h"
+
+struct CalculationResult {
+    int iter;
+    float distance_to_next_iteration;
+};
+
+// Calculation results of all points of the image, either as an array of CalculationResult (8 bytes per point)
+// or compact, in separate planes for the iterations and the fractions. The compact iterations are 8, 16 or 32
+// bit integers, whatever max_iterations needs, and distance_to_next_iteration (0 .. 1) is quantized to 16 bits.
+// The elements are not initialized when the storage is allocated (see WorkerFirstTouch).
+class CalculationResults {
+    template <typename T>
+    using Plane = std::vector<T, DefaultInitAllocator<T>>;
+
+    static constexpr float fraction_scale = 65535.0f;
+
+    bool compact_ = false;
+    int iteration_bits_ = 32;
+    std::size_t size_ = 0;
+
+    Plane<CalculationResult> points_;
+    Plane<std::uint8_t> iterations8_;
+    Plane<std::uint16_t> iterations16_;
+    Plane<std::uint32_t> iterations32_;
+    Plane<std::uint16_t> fractions_;
+
+    // the narrower iterations while they are widened (see reserve_iterations)
+    int narrow_iteration_bits_ = 0;
+    Plane<std::uint8_t> narrow_iterations8_;
+    Plane<std::uint16_t> narrow_iterations16_;
+
+    [[nodiscard]] static int iteration_bits_for(const int max_iterations);
+    void allocate_iterations();
+
+public:
+    CalculationResults() = default;
+    CalculationResults(const std::size_t size, const bool compact, const int max_iterations);
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] bool compact() const noexcept { return compact_; }
+    [[nodiscard]] int iteration_bits() const noexcept { return compact_ ? iteration_bits_ : 32; }
+    [[nodiscard]] std::size_t bytes_per_point() const noexcept { return compact_ ? static_cast<std::size_t>(iteration_bits_ / 8) + sizeof(std::uint16_t) : sizeof(CalculationResult); }
+
+    // consecutive results for the kernels, nullptr if the storage is compact
+    [[nodiscard]] CalculationResult* data() noexcept { return compact_ ? nullptr : points_.data(); }
+
+    [[nodiscard]] int iter(const std::size_t i) const noexcept
+    {
+        if (!compact_)
+            return points_[i].iter;
+
+        switch (iteration_bits_) {
+        case 8:
+            return iterations8_[i];
+        case 16:
+            return iterations16_[i];
+        default:
+            return static_cast<int>(iterations32_[i]);
+        }
+    }
+
+    [[nodiscard]] CalculationResult get(const std::size_t i) const noexcept
+    {
+        if (!compact_)
+            return points_[i];
+
+        return CalculationResult{iter(i), static_cast<float>(fractions_[i]) / fraction_scale};
+    }
+
+    void set(const std::size_t i, const CalculationResult& result) noexcept
+    {
+        if (!compact_) {
+            points_[i] = result;
+            return;
+        }
+
+        switch (iteration_bits_) {
+        case 8:
+            iterations8_[i] = static_cast<std::uint8_t>(result.iter);
+            break;
+        case 16:
+            iterations16_[i] = static_cast<std::uint16_t>(result.iter);
+            break;
+        default:
+            iterations32_[i] = static_cast<std::uint32_t>(result.iter);
+        }
+
+        fractions_[i] = static_cast<std::uint16_t>(std::lround(std::clamp(result.distance_to_next_iteration, 0.0f, 1.0f) * fraction_scale));
+    }
+
+    // copy count consecutive results, starting at begin, into separate arrays of iterations and fractions
+    void unpack(const std::size_t begin, const std::size_t count, int* iterations, float* fractions) const noexcept;
+
+    // set the results [begin, end) to zero
+    void zero(const std::size_t begin, const std::size_t end);
+
+    // Make sure that the iterations can hold max_iterations. If compact iterations have to be widened, the wider
+    // iterations are allocated without initializing them and true is returned. Then widen_iterations has to copy
+    // the values of all points (by the workers that own them, see WorkerFirstTouch) before finish_widening.
+    bool reserve_iterations(const int max_iterations);
+    void widen_iterations(const std::size_t begin, const std::size_t end);
+    void finish_widening();
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Allocator that default-initializes the elements a vector creates without a value, so resizing a vector of
+// trivial types leaves its memory untouched. The memory pages are then placed on the NUMA node of the thread
+// that first writes to them instead of the node of the thread that allocated the vector.
+template <typename T>
+class DefaultInitAllocator : public std::allocator<T> {
+public:
+    template <typename U>
+    struct rebind {
+        using other = DefaultInitAllocator<U>;
+    };
+
+    DefaultInitAllocator() noexcept = default;
+
+    template <typename U>
+    DefaultInitAllocator(const DefaultInitAllocator<U>&) noexcept {}
+
+    template <typename U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible_v<U>)
+    {
+        ::new (static_cast<void*>(p)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "queue_statistics.h"
+
+// Bounded multi-producer multi-consumer message queue on a ring buffer (Vyukov's algorithm).
+// Every cell carries a sequence number that tells producers and consumers whether it is free
+// or holds a message for the current lap, so send and receive only need one compare-and-swap
+// on the head or tail index. Receivers block on an atomic wait instead of a condition variable;
+// senders block the same way while the queue is full.
+template <typename T>
+class LockFreeMessageQueue {
+    static constexpr std::size_t cache_line_size = 64;
+
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T msg;
+    };
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(cache_line_size) std::atomic<std::size_t> tail_ = 0;  // next cell to write
+    alignas(cache_line_size) std::atomic<std::size_t> head_ = 0;  // next cell to read
+
+    // bumped after every send and receive, the blocked threads wait for them to change
+    alignas(cache_line_size) std::atomic<std::uint32_t> messages_signal_ = 0;
+    std::atomic<std::uint32_t> space_signal_ = 0;
+    std::atomic<int> waiting_receivers_ = 0;
+    std::atomic<int> waiting_senders_ = 0;
+
+    std::atomic<std::int64_t> contended_locks_ = 0;
+    std::atomic<std::int64_t> waits_ = 0;
+
+    [[nodiscard]] bool try_send(T& msg);
+    [[nodiscard]] std::optional<T> try_receive();
+
+public:
+    static constexpr std::size_t default_capacity = 8192;
+
+    explicit LockFreeMessageQueue(const std::size_t capacity = default_capacity);
+
+    void send(T&& msg);
+
+    [[nodiscard]] T wait_for_message();
+
+    void notify_one() { messages_signal_.notify_one(); };
+    void notify_all() { messages_signal_.notify_all(); };
+
+    int clear();
+    [[nodiscard]] bool empty() const { return size() == 0; };
+    [[nodiscard]] std::size_t size() const;
+
+    [[nodiscard]] QueueStatistics statistics() const { return QueueStatistics{contended_locks_, waits_, 0, 0}; };
+    void reset_statistics();
+};
+
+template <typename T>
+LockFreeMessageQueue<T>::LockFreeMessageQueue(const std::size_t capacity)
+    : capacity_{std::bit_ceil(std::max<std::size_t>(capacity, 2))}, mask_{capacity_ - 1}, cells_{std::make_unique<Cell[]>(capacity_)}
+{
+    for (std::size_t i = 0; i < capacity_; ++i)
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template <typename T>
+[[nodiscard]] bool LockFreeMessageQueue<T>::try_send(T& msg)
+{
+    std::size_t pos = tail_.load(std::memory_order_relaxed);
+
+    while (true) {
+        Cell& cell = cells_[pos & mask_];
+        const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+        if (diff == 0) {
+            if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.msg = std::move(msg);
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+            ++contended_locks_;
+        } else if (diff < 0) {
+            return false;  // full
+        } else {
+            pos = tail_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+[[nodiscard]] std::optional<T> LockFreeMessageQueue<T>::try_receive()
+{
+    std::size_t pos = head_.load(std::memory_order_relaxed);
+
+    while (true) {
+        Cell& cell = cells_[pos & mask_];
+        const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+
+        if (diff == 0) {
+            if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                T msg = std::move(cell.msg);
+                cell.sequence.store(pos + capacity_, std::memory_order_release);
+                return msg;
+            }
+
+            ++contended_locks_;
+        } else if (diff < 0) {
+            return std::nullopt;  // empty
+        } else {
+            pos = head_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+void LockFreeMessageQueue<T>::send(T&& msg)
+{
+    while (true) {
+        const std::uint32_t signal = space_signal_.load();
+
+        if (try_send(msg))
+            break;
+
+        ++waiting_senders_;
+        space_signal_.wait(signal);
+        --waiting_senders_;
+    }
+
+    ++messages_signal_;
+
+    if (waiting_receivers_ > 0)
+        messages_signal_.notify_one();
+}
+
+template <typename T>
+[[nodiscard]] T LockFreeMessageQueue<T>::wait_for_message()
+{
+    bool waited = false;
+
+    while (true) {
+        const std::uint32_t signal = messages_signal_.load();
+
+        if (auto msg = try_receive()) {
+            ++space_signal_;
+
+            if (waiting_senders_ > 0)
+                space_signal_.notify_one();
+
+            return std::move(*msg);
+        }
+
+        if (!waited) {
+            ++waits_;
+            waited = true;
+        }
+
+        ++waiting_receivers_;
+        messages_signal_.wait(signal);
+        --waiting_receivers_;
+    }
+}
+
+template <typename T>
+int LockFreeMessageQueue<T>::clear()
+{
+    int messages_removed = 0;
+
+    while (try_receive())
+        ++messages_removed;
+
+    if (messages_removed > 0) {
+        ++space_signal_;
+        space_signal_.notify_all();
+    }
+
+    return messages_removed;
+}
+
+template <typename T>
+[[nodiscard]] std::size_t LockFreeMessageQueue<T>::size() const
+{
+    const std::size_t head = head_.load();
+    const std::size_t tail = tail_.load();
+
+    return tail > head ? tail - head : 0;
+}
+
+template <typename T>
+void LockFreeMessageQueue<T>::reset_statistics()
+{
+    contended_locks_ = 0;
+    waits_ = 0;
+}
@@ -1,15 +1,24 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
 #include <queue>
 
+#include "queue_statistics.h"
+
 template <typename T>
 class MessageQueue {
     std::mutex mtx_;
     std::condition_variable cv_;
     std::queue<T> queue_;
 
+    std::atomic<std::int64_t> contended_locks_ = 0;
+    std::atomic<std::int64_t> waits_ = 0;
+
+    [[nodiscard]] std::unique_lock<std::mutex> lock();
+
 public:
     void send(T&& msg);
 
@@ -21,13 +30,29 @@ public:
     int clear();
     [[nodiscard]] bool empty();
     [[nodiscard]] auto size();
+
+    [[nodiscard]] QueueStatistics statistics() const { return QueueStatistics{contended_locks_, waits_, 0, 0}; };
+    void reset_statistics();
 };
 
+template <typename T>
+[[nodiscard]] std::unique_lock<std::mutex> MessageQueue<T>::lock()
+{
+    std::unique_lock<std::mutex> lock(mtx_, std::try_to_lock);
+
+    if (!lock.owns_lock()) {
+        ++contended_locks_;
+        lock.lock();
+    }
+
+    return lock;
+}
+
 template <typename T>
 void MessageQueue<T>::send(T&& msg)
 {
     {
-        std::lock_guard<std::mutex> lock(mtx_);
+        auto lck = lock();
         queue_.emplace(std::move(msg));
     }
 
@@ -37,8 +62,12 @@ void MessageQueue<T>::send(T&& msg)
 template <typename T>
 [[nodiscard]] T MessageQueue<T>::wait_for_message()
 {
-    std::unique_lock<std::mutex> lock(mtx_);
-    cv_.wait(lock, [&] { return !queue_.empty(); });
+    auto lck = lock();
+
+    if (queue_.empty())
+        ++waits_;
+
+    cv_.wait(lck, [&] { return !queue_.empty(); });
 
     T msg = std::move(queue_.front());
     queue_.pop();
@@ -49,7 +78,7 @@ template <typename T>
 template <typename T>
 int MessageQueue<T>::clear()
 {
-    std::lock_guard<std::mutex> lock(mtx_);
+    auto lck = lock();
     int messages_removed = 0;
 
     while (!queue_.empty()) {
@@ -63,13 +92,20 @@ int MessageQueue<T>::clear()
 template <typename T>
 [[nodiscard]] bool MessageQueue<T>::empty()
 {
-    std::lock_guard<std::mutex> lock(mtx_);
+    auto lck = lock();
     return queue_.empty();
 }
 
 template <typename T>
 [[nodiscard]] auto MessageQueue<T>::size()
 {
-    std::lock_guard<std::mutex> lock(mtx_);
+    auto lck = lock();
     return queue_.size();
 }
+
+template <typename T>
+void MessageQueue<T>::reset_statistics()
+{
+    contended_locks_ = 0;
+    waits_ = 0;
+}
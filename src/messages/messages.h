@@ -1,18 +1,46 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <latch>
 #include <memory>
+#include <type_traits>
 #include <variant>
 #include <vector>
 
 #include <SFML/Config.hpp>
 
+#include "calculation_results.h"
+#include "default_init_allocator.h"
+#include "result_layout.h"
 #include "gradient/gradient.h"
-
-struct CalculationResult {
-    int iter;
-    float distance_to_next_iteration;
+#include "mandelbrot/fixed_point.h"
+#include "mandelbrot/kernel.h"
+#include "mandelbrot/precision.h"
+#include "mandelbrot/strategy.h"
+
+struct ReferenceOrbit;
+
+// Last orbit point of a point that has not escaped, used to resume the calculation when
+// max_iterations is raised. With perturbation it is the delta against the reference orbit at
+// reference_index, the full value would lose the tiny delta of the point.
+struct OrbitState {
+    double x, y;
+    int reference_index;
 };
 
+// Per point buffers of the image (besides CalculationResults). Their elements are not initialized when the buffers
+// are allocated, the workers initialize them (see WorkerFirstTouch) so that the pages end up on the NUMA nodes of
+// the workers.
+using OrbitStates = std::vector<OrbitState, DefaultInitAllocator<OrbitState>>;
+using PixelBuffer = std::vector<sf::Uint8, DefaultInitAllocator<sf::Uint8>>;
+using GradientPositions = std::vector<float, DefaultInitAllocator<float>>;  // per pixel, row-major like PixelBuffer
+
+// otherwise allocating the buffers would already initialize all elements on the allocating thread
+static_assert(std::is_trivially_default_constructible_v<OrbitStates::value_type>);
+static_assert(std::is_trivially_default_constructible_v<PixelBuffer::value_type>);
+static_assert(std::is_trivially_default_constructible_v<GradientPositions::value_type>);
+
 struct ImageSize {
     int width, height;
 };
@@ -26,18 +54,38 @@ struct Scroll {
     int x, y;
 };
 
+// Zoom about the image center, factor is 1 if the image has not been zoomed.
+struct Zoom {
+    int factor;
+    bool out;
+};
+
 struct FractalSection {
-    double center_x, center_y, height;
+    FixedPoint center_x, center_y;
+    double height;
+
+    bool operator==(const FractalSection& other) const = default;
+};
+
+struct CalculationStatistics {
+    std::int64_t iterations_saved;
+    std::int64_t rebases;
+    std::int64_t calculated_points;
+    std::int64_t filled_points;
 };
 
 // ---- Supervisor messages -----------
 struct SupervisorImageRequest {
     int max_iterations;
     int tile_size;
+    bool adaptive_tile_size;
+    bool pipelined_colorization;
     ImageSize image_size;
     CalculationArea area;
     Scroll scroll;
+    Zoom zoom;
     FractalSection fractal_section;
+    CalculationStrategy strategy;
 };
 
 struct SupervisorCalculationResults {
@@ -45,7 +93,10 @@ struct SupervisorCalculationResults {
     ImageSize image_size;
     CalculationArea area;
     FractalSection fractal_section;
-    std::vector<CalculationResult>* results_per_point;
+    std::uint64_t generation;
+    CalculationStatistics statistics;
+    float calculation_time;  // seconds
+    CalculationResults* results_per_point;
     std::unique_ptr<sf::Uint8[]> pixels;
 };
 
@@ -53,7 +104,7 @@ struct SupervisorColorizationResults {
     int start_row;
     int num_rows;
     int row_width;
-    std::vector<sf::Uint8>* colorization_buffer;
+    PixelBuffer* colorization_buffer;
 };
 
 struct SupervisorColorize {
@@ -73,7 +124,21 @@ struct WorkerCalculate {
     ImageSize image_size;
     CalculationArea area;
     FractalSection fractal_section;
-    std::vector<CalculationResult>* results_per_point;
+    CalculationStrategy strategy;
+    Kernel kernel;
+    Precision precision;
+    std::shared_ptr<const ReferenceOrbit> reference_orbit;
+    int resume_iterations;  // continue points that did not escape after this many iterations, 0 to calculate all points
+    int grid_step;  // only calculate points whose coordinates are multiples of grid_step
+    bool skip_coarser_grid;  // points on the grid of 2 * grid_step are already known
+    std::uint64_t generation;  // the calculation is canceled once current_generation differs
+    const std::atomic<std::uint64_t>* current_generation;
+    bool build_histogram;  // add the iterations of all points of the tile to the worker's histogram of this generation
+    const std::vector<float>* provisional_equalized_iterations;  // colorize the tile with these, or draw a grayscale preview if null
+    const Gradient* gradient;
+    CalculationResults* results_per_point;
+    OrbitStates* orbits_per_point;
+    ResultLayout result_layout;
     std::unique_ptr<sf::Uint8[]> pixels;
 };
 
@@ -81,13 +146,36 @@ struct WorkerColorize {
     int max_iterations;
     int start_row;
     int num_rows;
+    int start_column;  // only the columns [start_column, start_column + num_columns) of the rows, e.g. after scrolling
+    int num_columns;
     int row_width;
+    std::size_t pixel_origin;  // position of pixel 0, 0 in the pixel buffers, which wrap around like a ring buffer
+    Kernel kernel;
     Gradient* gradient;
-    std::vector<CalculationResult>* results_per_point;
+    CalculationResults* results_per_point;
+    ResultLayout result_layout;
     std::vector<float>* equalized_iterations;
-    std::vector<sf::Uint8>* colorization_buffer;
+    GradientPositions* gradient_positions;  // position of the color of each pixel in the gradient, negative for black
+    bool lookup_only;  // the gradient positions are up to date (only the gradient has changed), just look up the colors
+    PixelBuffer* colorization_buffer;
+};
+
+// Zero the rows [start_row, start_row + num_rows) of freshly allocated buffers, so that their memory is first
+// touched by the worker that owns these rows. The band starts and ends at multiples of ResultLayout::tile_size
+// (or the bottom of the image). Counts down done when finished.
+struct WorkerFirstTouch {
+    int start_row;
+    int num_rows;
+    int row_width;
+    bool widen_iterations;  // only copy the iterations into their just widened storage (see CalculationResults::reserve_iterations)
+    CalculationResults* results_per_point;
+    OrbitStates* orbits_per_point;
+    ResultLayout result_layout;
+    GradientPositions* gradient_positions;
+    PixelBuffer* colorization_buffer;
+    std::latch* done;
 };
 
 struct WorkerQuit {};
 
-using WorkerMessage = std::variant<WorkerCalculate, WorkerColorize, WorkerQuit>;
+using WorkerMessage = std::variant<WorkerCalculate, WorkerColorize, WorkerFirstTouch, WorkerQuit>;
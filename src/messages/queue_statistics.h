@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+// Counters to compare how much the worker threads get in each other's way.
+struct QueueStatistics {
+    std::int64_t contended_locks;  // lock acquisitions (or compare-and-swaps) that had to wait for (or retry after) another thread
+    std::int64_t waits;            // receivers that found no message and had to sleep
+    std::int64_t steals;           // messages taken from another worker's queue
+    std::int64_t failed_steals;    // other workers' queues that have been found empty
+};
@@ -0,0 +1,31 @@
+#include "result_layout.h"
+
+#include "messages.h"
+
+const char* result_order_name(const ResultOrder result_order)
+{
+    switch (result_order) {
+    case ResultOrder::RowMajor:
+        return "rows";
+    case ResultOrder::TileMajor:
+        return "tiles";
+    default:
+        return "unknown";
+    }
+}
+
+ResultLayout::ResultLayout(const ResultOrder order, const ImageSize& image_size) :
+    order_{order}, width_{image_size.width}, height_{image_size.height}
+{
+    if (order_ == ResultOrder::RowMajor) {
+        size_ = static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_);
+    } else {
+        tiles_per_row_ = static_cast<std::size_t>((width_ + tile_size - 1) / tile_size);
+        size_ = tiles_per_row_ * static_cast<std::size_t>((height_ + tile_size - 1) / tile_size) * tile_points;
+    }
+}
+
+[[nodiscard]] bool ResultLayout::has_shape(const ResultOrder order, const ImageSize& image_size) const noexcept
+{
+    return order_ == order && width_ == image_size.width && height_ == image_size.height;
+}
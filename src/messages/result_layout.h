@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+struct ImageSize;
+
+// Order of the points in the per point buffers (calculation results and orbits).
+enum class ResultOrder {
+    RowMajor,
+    TileMajor,
+};
+
+const char* result_order_name(const ResultOrder result_order);
+
+// Maps image coordinates to the position of a point in the per point buffers. RowMajor stores the image
+// row by row. TileMajor stores it in tiles of tile_size x tile_size points, one tile after the other and
+// every tile row by row. A row of a tile is one cache line of results, so workers that calculate
+// neighboring areas with tile aligned edges never write to the same cache line, and the points of an
+// area are not spread over the whole image. Partial tiles at the right and bottom edge are padded, the
+// padding points stay zero.
+//
+// The buffers are a 2D ring buffer: the image starts at an origin in the buffers and wraps around at
+// their right and bottom edge. Scrolling only moves the origin, the points that stay visible are not
+// moved in memory.
+class ResultLayout {
+    ResultOrder order_ = ResultOrder::RowMajor;
+    int width_ = 0;
+    int height_ = 0;
+    int origin_x_ = 0;  // position of the image point 0, 0 in the buffers
+    int origin_y_ = 0;
+    std::size_t tiles_per_row_ = 0;
+    std::size_t size_ = 0;
+
+    [[nodiscard]] static int wrap(const int value, const int size) noexcept { return (value % size + size) % size; }
+
+    [[nodiscard]] std::size_t buffer_index(const int buffer_x, const int buffer_y) const noexcept
+    {
+        const auto ux = static_cast<std::size_t>(buffer_x);
+        const auto uy = static_cast<std::size_t>(buffer_y);
+
+        if (order_ == ResultOrder::RowMajor)
+            return uy * static_cast<std::size_t>(width_) + ux;
+
+        const std::size_t tile = (uy / tile_size) * tiles_per_row_ + ux / tile_size;
+        return tile * tile_points + (uy % tile_size) * tile_size + ux % tile_size;
+    }
+
+public:
+    static constexpr int tile_size = 8;
+    static constexpr std::size_t tile_points = tile_size * tile_size;
+
+    ResultLayout() = default;
+    ResultLayout(const ResultOrder order, const ImageSize& image_size);
+
+    [[nodiscard]] ResultOrder order() const noexcept { return order_; }
+    [[nodiscard]] bool has_shape(const ResultOrder order, const ImageSize& image_size) const noexcept;
+
+    // number of points in the buffers, including the padding
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] std::size_t padding_points() const noexcept { return size_ - static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_); }
+
+    // column and row of the buffers that hold column x and row y of the image
+    [[nodiscard]] int buffer_column(const int x) const noexcept { return x + origin_x_ < width_ ? x + origin_x_ : x + origin_x_ - width_; }
+    [[nodiscard]] int buffer_row(const int y) const noexcept { return y + origin_y_ < height_ ? y + origin_y_ : y + origin_y_ - height_; }
+
+    [[nodiscard]] std::size_t index(const int x, const int y) const noexcept
+    {
+        return buffer_index(buffer_column(x), buffer_row(y));
+    }
+
+    // Number of points of row y that follow each other in memory starting at x (at most up to x_end).
+    [[nodiscard]] int contiguous_points(const int x, const int x_end) const noexcept
+    {
+        const int buffer_x = buffer_column(x);
+        const int until_wrap = width_ - buffer_x;
+
+        if (order_ == ResultOrder::RowMajor)
+            return std::min(x_end - x, until_wrap);
+
+        return std::min({x_end - x, until_wrap, tile_size - buffer_x % tile_size});
+    }
+
+    // First position of the buffer rows >= buffer_y, buffer_y must be a multiple of tile_size or the image height.
+    [[nodiscard]] std::size_t buffer_rows_begin(const int buffer_y) const noexcept { return buffer_y >= height_ ? size_ : buffer_index(0, buffer_y); }
+
+    // Scrolling by dx, dy moves the point at x, y of the image to x - dx, y - dy.
+    void scroll(const int dx, const int dy) noexcept
+    {
+        origin_x_ = wrap(origin_x_ + dx, width_);
+        origin_y_ = wrap(origin_y_ + dy, height_);
+    }
+};
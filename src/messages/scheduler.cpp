@@ -0,0 +1,15 @@
+#include "scheduler.h"
+
+const char* scheduler_name(const Scheduler scheduler)
+{
+    switch (scheduler) {
+    case Scheduler::SharedQueue:
+        return "shared";
+    case Scheduler::LockFree:
+        return "lockfree";
+    case Scheduler::WorkStealing:
+        return "stealing";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+// How calculation and colorization messages are distributed to the worker threads.
+enum class Scheduler {
+    SharedQueue,
+    LockFree,
+    WorkStealing,
+};
+
+const char* scheduler_name(const Scheduler scheduler);
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "queue_statistics.h"
+
+// Message queue with one deque per receiver. Messages are distributed round-robin over the deques
+// unless the sender picks a receiver. A receiver takes its newest message first (LIFO) and, once its
+// own deque is empty, steals the oldest message of another receiver (FIFO), trying the receivers of
+// its own group (NUMA node) first. Each deque has its own lock, so receivers only compete with each
+// other while stealing. Messages sent with send_to() cannot be stolen.
+template <typename T>
+class WorkStealingQueue {
+    struct Deque {
+        std::mutex mtx;
+        std::deque<T> messages;
+        std::deque<T> pinned_messages;
+        std::atomic<std::int64_t> pinned_size = 0;
+        std::vector<std::size_t> victims;  // the other receivers in the order this one steals from them
+    };
+
+    std::vector<std::unique_ptr<Deque>> deques_;
+    std::atomic<std::size_t> next_deque_ = 0;
+
+    // number of stealable messages in all deques, changed while holding sleep_mtx_ when increased so that no wakeup gets lost
+    std::atomic<std::int64_t> size_ = 0;
+    std::mutex sleep_mtx_;
+    std::condition_variable sleep_cv_;
+
+    std::atomic<std::int64_t> contended_locks_ = 0;
+    std::atomic<std::int64_t> waits_ = 0;
+    std::atomic<std::int64_t> steals_ = 0;
+    std::atomic<std::int64_t> failed_steals_ = 0;
+
+    [[nodiscard]] std::unique_lock<std::mutex> lock(std::mutex& mtx);
+
+    [[nodiscard]] std::optional<T> pop_newest(const std::size_t receiver);
+    [[nodiscard]] std::optional<T> steal_oldest(const std::size_t receiver);
+
+public:
+    // must not be called while receivers are waiting for messages, groups holds the group of each receiver (or is empty)
+    void set_number_of_receivers(const int receivers, const std::vector<int>& groups = {});
+
+    void send(T&& msg);
+    void send(T&& msg, const int receiver);
+    void send_to(T&& msg, const int receiver);
+
+    [[nodiscard]] T wait_for_message(const int receiver);
+
+    int clear();
+    [[nodiscard]] bool empty() const { return size_ == 0; };
+
+    [[nodiscard]] QueueStatistics statistics() const { return QueueStatistics{contended_locks_, waits_, steals_, failed_steals_}; };
+    void reset_statistics();
+};
+
+template <typename T>
+[[nodiscard]] std::unique_lock<std::mutex> WorkStealingQueue<T>::lock(std::mutex& mtx)
+{
+    std::unique_lock<std::mutex> lock(mtx, std::try_to_lock);
+
+    if (!lock.owns_lock()) {
+        ++contended_locks_;
+        lock.lock();
+    }
+
+    return lock;
+}
+
+template <typename T>
+void WorkStealingQueue<T>::set_number_of_receivers(const int receivers, const std::vector<int>& groups)
+{
+    clear();
+
+    deques_.clear();
+
+    for (int i = 0; i < receivers; ++i)
+        deques_.push_back(std::make_unique<Deque>());
+
+    const auto group = [&](const std::size_t receiver) { return receiver < groups.size() ? groups[receiver] : 0; };
+
+    for (std::size_t r = 0; r < deques_.size(); ++r) {
+        auto& victims = deques_[r]->victims;
+
+        for (std::size_t i = 1; i < deques_.size(); ++i)
+            victims.push_back((r + i) % deques_.size());
+
+        std::stable_partition(victims.begin(), victims.end(), [&](const std::size_t victim) { return group(victim) == group(r); });
+    }
+}
+
+template <typename T>
+void WorkStealingQueue<T>::send(T&& msg)
+{
+    send(std::move(msg), static_cast<int>(next_deque_++ % deques_.size()));
+}
+
+template <typename T>
+void WorkStealingQueue<T>::send(T&& msg, const int receiver)
+{
+    Deque& deque = *deques_[static_cast<std::size_t>(receiver)];
+
+    {
+        auto lck = lock(deque.mtx);
+        deque.messages.push_back(std::move(msg));
+    }
+
+    {
+        auto lck = lock(sleep_mtx_);
+        ++size_;
+    }
+
+    sleep_cv_.notify_one();
+}
+
+template <typename T>
+void WorkStealingQueue<T>::send_to(T&& msg, const int receiver)
+{
+    Deque& deque = *deques_[static_cast<std::size_t>(receiver)];
+
+    {
+        auto lck = lock(deque.mtx);
+        deque.pinned_messages.push_back(std::move(msg));
+    }
+
+    {
+        auto lck = lock(sleep_mtx_);
+        ++deque.pinned_size;
+    }
+
+    // only this receiver may take the message, so wake all of them
+    sleep_cv_.notify_all();
+}
+
+template <typename T>
+[[nodiscard]] std::optional<T> WorkStealingQueue<T>::pop_newest(const std::size_t receiver)
+{
+    Deque& deque = *deques_[receiver];
+    auto lck = lock(deque.mtx);
+
+    if (!deque.pinned_messages.empty()) {
+        T msg = std::move(deque.pinned_messages.front());
+        deque.pinned_messages.pop_front();
+        --deque.pinned_size;
+
+        return msg;
+    }
+
+    if (deque.messages.empty())
+        return std::nullopt;
+
+    T msg = std::move(deque.messages.back());
+    deque.messages.pop_back();
+    --size_;
+
+    return msg;
+}
+
+template <typename T>
+[[nodiscard]] std::optional<T> WorkStealingQueue<T>::steal_oldest(const std::size_t receiver)
+{
+    for (const std::size_t victim : deques_[receiver]->victims) {
+        Deque& deque = *deques_[victim];
+        auto lck = lock(deque.mtx);
+
+        if (deque.messages.empty()) {
+            ++failed_steals_;
+            continue;
+        }
+
+        T msg = std::move(deque.messages.front());
+        deque.messages.pop_front();
+        --size_;
+        ++steals_;
+
+        return msg;
+    }
+
+    return std::nullopt;
+}
+
+template <typename T>
+[[nodiscard]] T WorkStealingQueue<T>::wait_for_message(const int receiver)
+{
+    const auto r = static_cast<std::size_t>(receiver);
+
+    while (true) {
+        if (auto msg = pop_newest(r))
+            return std::move(*msg);
+
+        if (auto msg = steal_oldest(r))
+            return std::move(*msg);
+
+        const auto& pinned_size = deques_[r]->pinned_size;
+        std::unique_lock<std::mutex> lck(sleep_mtx_);
+
+        if (size_ == 0 && pinned_size == 0)
+            ++waits_;
+
+        sleep_cv_.wait(lck, [&] { return size_ > 0 || pinned_size > 0; });
+    }
+}
+
+template <typename T>
+int WorkStealingQueue<T>::clear()
+{
+    int messages_removed = 0;
+
+    for (auto& deque : deques_) {
+        auto lck = lock(deque->mtx);
+        messages_removed += static_cast<int>(deque->messages.size() + deque->pinned_messages.size());
+        size_ -= static_cast<std::int64_t>(deque->messages.size());
+        deque->pinned_size -= static_cast<std::int64_t>(deque->pinned_messages.size());
+        deque->messages.clear();
+        deque->pinned_messages.clear();
+    }
+
+    return messages_removed;
+}
+
+template <typename T>
+void WorkStealingQueue<T>::reset_statistics()
+{
+    contended_locks_ = 0;
+    waits_ = 0;
+    steals_ = 0;
+    failed_steals_ = 0;
+}
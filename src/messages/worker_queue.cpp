@@ -0,0 +1,75 @@
+#include "worker_queue.h"
+
+void WorkerQueue::set_number_of_workers(const int workers, const std::vector<int>& worker_nodes)
+{
+    if (scheduler_ == Scheduler::WorkStealing)
+        work_stealing_queue_.set_number_of_receivers(workers, worker_nodes);
+}
+
+void WorkerQueue::send(WorkerMessage&& msg, const int preferred_worker)
+{
+    switch (scheduler_) {
+    case Scheduler::LockFree:
+        lock_free_queue_.send(std::move(msg));
+        break;
+    case Scheduler::WorkStealing:
+        if (preferred_worker >= 0)
+            work_stealing_queue_.send(std::move(msg), preferred_worker);
+        else
+            work_stealing_queue_.send(std::move(msg));
+        break;
+    default:
+        shared_queue_.send(std::move(msg));
+    }
+}
+
+void WorkerQueue::send_to(WorkerMessage&& msg, const int worker_id)
+{
+    if (scheduler_ == Scheduler::WorkStealing)
+        work_stealing_queue_.send_to(std::move(msg), worker_id);
+    else
+        send(std::move(msg));
+}
+
+[[nodiscard]] WorkerMessage WorkerQueue::wait_for_message(const int worker_id)
+{
+    switch (scheduler_) {
+    case Scheduler::LockFree:
+        return lock_free_queue_.wait_for_message();
+    case Scheduler::WorkStealing:
+        return work_stealing_queue_.wait_for_message(worker_id);
+    default:
+        return shared_queue_.wait_for_message();
+    }
+}
+
+int WorkerQueue::clear()
+{
+    switch (scheduler_) {
+    case Scheduler::LockFree:
+        return lock_free_queue_.clear();
+    case Scheduler::WorkStealing:
+        return work_stealing_queue_.clear();
+    default:
+        return shared_queue_.clear();
+    }
+}
+
+[[nodiscard]] QueueStatistics WorkerQueue::statistics() const
+{
+    switch (scheduler_) {
+    case Scheduler::LockFree:
+        return lock_free_queue_.statistics();
+    case Scheduler::WorkStealing:
+        return work_stealing_queue_.statistics();
+    default:
+        return shared_queue_.statistics();
+    }
+}
+
+void WorkerQueue::reset_statistics()
+{
+    shared_queue_.reset_statistics();
+    lock_free_queue_.reset_statistics();
+    work_stealing_queue_.reset_statistics();
+}
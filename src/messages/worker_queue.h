@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include "lock_free_message_queue.h"
+#include "message_queue.h"
+#include "messages.h"
+#include "scheduler.h"
+#include "work_stealing_queue.h"
+
+// Queue of the messages for the worker threads, either one queue shared by all workers (with a
+// lock or lock-free) or one work-stealing deque per worker.
+class WorkerQueue {
+    const Scheduler scheduler_;
+
+    MessageQueue<WorkerMessage> shared_queue_;
+    LockFreeMessageQueue<WorkerMessage> lock_free_queue_;
+    WorkStealingQueue<WorkerMessage> work_stealing_queue_;
+
+public:
+    // the ring buffer of the lock-free queue is only allocated at full size if it is used
+    WorkerQueue(const Scheduler scheduler) : scheduler_{scheduler}, lock_free_queue_{scheduler == Scheduler::LockFree ? LockFreeMessageQueue<WorkerMessage>::default_capacity : 2} {}
+
+    [[nodiscard]] Scheduler scheduler() const { return scheduler_; }
+
+    // worker_nodes holds the NUMA node of each worker, the work-stealing deques steal within a node first
+    void set_number_of_workers(const int workers, const std::vector<int>& worker_nodes);
+
+    // preferred_worker only has an effect with the work-stealing scheduler, the message can still be stolen
+    void send(WorkerMessage&& msg, const int preferred_worker = -1);
+
+    // only worker_id will receive the message with the work-stealing scheduler, any worker with shared queues
+    void send_to(WorkerMessage&& msg, const int worker_id);
+    [[nodiscard]] WorkerMessage wait_for_message(const int worker_id);
+
+    int clear();
+
+    [[nodiscard]] QueueStatistics statistics() const;
+    void reset_statistics();
+};
@@ -0,0 +1,80 @@
+#include "pixel_buffer_pool.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+[[nodiscard]] PixelBufferPool::SizeClass& PixelBufferPool::size_class(const std::size_t size)
+{
+    const auto index = static_cast<std::size_t>(std::bit_width(std::bit_ceil(size)));
+
+    if (size_classes_.size() <= index)
+        size_classes_.resize(index + 1);
+
+    return size_classes_[index];
+}
+
+[[nodiscard]] std::unique_ptr<sf::Uint8[]> PixelBufferPool::acquire(const std::size_t size)
+{
+    SizeClass& size_class = this->size_class(size);
+    ++acquired_;
+
+    size_class.max_in_use = std::max(size_class.max_in_use, ++size_class.in_use);
+    size_class.used_by_request = true;
+
+    if (!size_class.free_buffers.empty()) {
+        auto buffer = std::move(size_class.free_buffers.back());
+        size_class.free_buffers.pop_back();
+        free_bytes_ -= std::bit_ceil(size);
+        return buffer;
+    }
+
+    ++allocated_;
+    return std::make_unique_for_overwrite<sf::Uint8[]>(std::bit_ceil(size));
+}
+
+void PixelBufferPool::release(std::unique_ptr<sf::Uint8[]> buffer, const std::size_t size)
+{
+    if (!buffer)
+        return;
+
+    SizeClass& size_class = this->size_class(size);
+    --size_class.in_use;
+
+    if (size_class.free_buffers.size() >= size_class.max_in_use || free_bytes_ + std::bit_ceil(size) > max_free_bytes_)
+        return;  // freed
+
+    size_class.free_buffers.push_back(std::move(buffer));
+    free_bytes_ += std::bit_ceil(size);
+}
+
+void PixelBufferPool::start_request(const std::size_t max_free_bytes)
+{
+    max_free_bytes_ = max_free_bytes;
+
+    for (std::size_t index = 0; index < size_classes_.size(); ++index) {
+        SizeClass& size_class = size_classes_[index];
+
+        // e.g. the tile size has changed
+        if (!size_class.used_by_request) {
+            free_bytes_ -= size_class.free_buffers.size() * (std::size_t{1} << (index - 1));
+            size_class.free_buffers.clear();
+            size_class.max_in_use = size_class.in_use;
+        }
+
+        size_class.used_by_request = false;
+    }
+
+    // e.g. the image has become smaller
+    for (std::size_t index = size_classes_.size(); index-- > 0 && free_bytes_ > max_free_bytes_;) {
+        SizeClass& size_class = size_classes_[index];
+
+        while (!size_class.free_buffers.empty() && free_bytes_ > max_free_bytes_) {
+            size_class.free_buffers.pop_back();
+            free_bytes_ -= std::size_t{1} << (index - 1);
+        }
+    }
+
+    acquired_ = 0;
+    allocated_ = 0;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <SFML/Config.hpp>
+
+// Reusable pixel buffers for the tile previews. The supervisor takes a buffer for every tile it sends and
+// returns it when the results come back and the pixels have been uploaded, so after the first requests
+// no buffers are allocated any more. Buffers are kept in power of two size classes, a tile gets a buffer
+// of the class of its size. Each class keeps as many free buffers as were in use at once during a request,
+// so a request with as many tiles as an earlier one allocates nothing. The classes of a tile size that was
+// not used by the last request are freed, and the free buffers never exceed a byte budget. Only used by
+// the supervisor thread.
+class PixelBufferPool {
+    struct SizeClass {
+        std::vector<std::unique_ptr<sf::Uint8[]>> free_buffers;
+        std::size_t in_use = 0;
+        std::size_t max_in_use = 0;
+        bool used_by_request = false;
+    };
+
+    std::vector<SizeClass> size_classes_;
+    std::size_t free_bytes_ = 0;
+    std::size_t max_free_bytes_ = 0;
+
+    std::int64_t acquired_ = 0;
+    std::int64_t allocated_ = 0;
+
+    [[nodiscard]] SizeClass& size_class(const std::size_t size);
+
+public:
+    // buffer for at least size bytes
+    [[nodiscard]] std::unique_ptr<sf::Uint8[]> acquire(const std::size_t size);
+    void release(std::unique_ptr<sf::Uint8[]> buffer, const std::size_t size);
+
+    // called for every request before its first buffer is acquired, frees the classes the last request did not
+    // use and resets the statistics
+    void start_request(const std::size_t max_free_bytes);
+
+    // memory of the buffers kept for reuse
+    [[nodiscard]] std::size_t free_bytes() const { return free_bytes_; }
+
+    // number of buffers handed out and number of them that had to be allocated since the start of the request
+    [[nodiscard]] std::int64_t acquired() const { return acquired_; }
+    [[nodiscard]] std::int64_t allocated() const { return allocated_; }
+};
@@ -1,16 +1,31 @@
 #include "supervisor.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <functional>
+#include <latch>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <utility>
 
 #include <spdlog/spdlog.h>
 
 #include "command_line/command_line.h"
+#include "clock/stopwatch.h"
 #include "mandelbrot/mandelbrot.h"
+#include "mandelbrot/perturbation.h"
 
 Supervisor::Supervisor(const CommandLine& cli, Window& window)
-    : running_{false}, window_{window}, gradient_{load_gradient("benchmark")}
+    : running_{false}, kernel_{cli.kernel()}, tile_order_{cli.tile_order()}, pin_threads_{cli.pin_threads()}, compact_results_{cli.compact_results()}, window_{window}, gradient_{load_gradient("benchmark", cli.gradient_lookup_table_size())}, worker_message_queue_{cli.scheduler()},
+      result_order_{cli.result_order()}
 {
+    spdlog::info("using calculation kernel: {}", kernel_name(kernel_));
+    spdlog::info("using scheduler: {}", scheduler_name(worker_message_queue_.scheduler()));
+    spdlog::info("using tile order: {}", tile_order_name(tile_order_));
+    spdlog::info("using result layout: {}", result_order_name(result_order_));
     run(cli.num_threads());
 }
 
@@ -48,6 +63,7 @@ void Supervisor::main()
 
     status_.set_phase(Phase::Shutdown);
 
+    ++generation_;
     clear_message_queues();
     shutdown_workers();
 
@@ -90,17 +106,126 @@ void Supervisor::handle_message(SupervisorImageRequest&& image_request)
         image_request.area.x, image_request.area.y, image_request.area.width, image_request.area.height,
         image_request.tile_size);
 
+    if (workers_busy()) {
+        // do not wait for the running calculation, cancel it and continue with this request once the workers have stopped
+        spdlog::debug("supervisor: image request supersedes the running calculation");
+
+        if (!cancel_clock_)
+            cancel_running_calculation();
+
+        // the scroll or zoom of this request is relative to the dropped request, which never changed the buffers
+        if (superseding_image_request_) {
+            spdlog::debug("supervisor: dropping the previous superseding image request, recalculating the whole image");
+            image_incomplete_ = true;
+        }
+
+        superseding_image_request_ = std::move(image_request);
+        status_.set_phase(Phase::Canceled);
+        return;
+    }
+
     status_.start_calculation(Phase::RequestReceived);
+    ++generation_;
+    statistics_ = CalculationStatistics{};
+    worker_message_queue_.reset_statistics();
+    // the buffers of all tiles of the image fit, even if rounded up to the next power of two
+    pixel_buffer_pool_.start_request(static_cast<std::size_t>(2 * 4 * image_request.image_size.width * image_request.image_size.height));
+    tile_finish_times_.clear();
+    tile_size_tuner_.start_calculation();
+    status_.clear_tiles();
+
+    int resume_from = resume_iterations(image_request);
+    const Precision previous_precision = precision_.precision;
 
     bool recalculation_needed = resize_and_reset_buffers_if_needed(image_request.image_size, image_request.max_iterations);
 
-    if (recalculation_needed)
+    if (recalculation_needed || image_incomplete_)
         modify_image_request_for_recalculation(image_request);
 
-    if (should_scroll(image_request))
+    image_incomplete_ = false;
+
+    update_precision(image_request);
+    update_reference_orbit(image_request);
+
+    // perturbation stores the orbits as deltas against the reference orbit, the other precisions as full values
+    if ((precision_.precision == Precision::Perturbation) != (previous_precision == Precision::Perturbation))
+        resume_from = 0;
+
+    std::vector<CalculationArea> areas{image_request.area};
+    bool skip_even_points = false;
+
+    histogram_update_ = HistogramUpdate::WholeImage;
+    scrolled_image_request_.reset();
+    known_points_area_ = CalculationArea{0, 0, image_request.image_size.width, image_request.image_size.height};
+
+    if (should_scroll(image_request)) {
+        // the colors of the previous image can only be moved along if all of them have been calculated
+        scrolled_image_request_ = image_request;
+        scrolled_colors_complete_ = gradient_positions_max_iterations_ == image_request.max_iterations && equalized_max_iterations_ == image_request.max_iterations;
+
+        if (histogram_valid_) {
+            remove_scrolled_off_points_from_histogram(image_request);
+            histogram_update_ = HistogramUpdate::Incremental;
+        }
+
         scroll_results_per_point_array(image_request);
 
-    send_calculation_messages(image_request);
+        // the strip that is scrolled in holds the points that were scrolled off on the other side
+        const CalculationArea& strip = image_request.area;
+
+        if (strip.width == image_request.image_size.width && strip.height < image_request.image_size.height)
+            known_points_area_ = CalculationArea{0, strip.y == 0 ? strip.height : 0, strip.width, image_request.image_size.height - strip.height};
+        else if (strip.height == image_request.image_size.height && strip.width < image_request.image_size.width)
+            known_points_area_ = CalculationArea{strip.x == 0 ? strip.width : 0, 0, image_request.image_size.width - strip.width, strip.height};
+    } else if (should_zoom(image_request) && precision_.precision == previous_precision) {
+        zoom_results_per_point_array(image_request);
+
+        if (image_request.zoom.out) {
+            areas = areas_around_zoomed_out_image(image_request.image_size);
+
+            const int border_x = image_request.image_size.width / 4;
+            const int border_y = image_request.image_size.height / 4;
+            known_points_area_ = CalculationArea{border_x, border_y, image_request.image_size.width - 2 * border_x, image_request.image_size.height - 2 * border_y};
+        } else
+            skip_even_points = true;
+
+        spdlog::info("supervisor: zoom reused {} points", image_request.image_size.width * image_request.image_size.height / 4);
+    } else {
+        image_request.zoom = Zoom{1, false};
+    }
+
+    update_resumable_image_request(image_request);
+    image_fractal_section_ = image_request.fractal_section;
+
+    // without a final recolor the tiles have to cover the whole image, otherwise the rest of it would keep its old colors
+    const bool whole_image = areas.size() == 1 && areas.front().width == image_request.image_size.width && areas.front().height == image_request.image_size.height;
+    image_colorized_provisionally_ = whole_image && provisional_equalized_iterations(image_request) != nullptr;
+
+    if (whole_image)
+        histogram_update_ = HistogramUpdate::FromWorkers;
+
+    // until the new points have been added the histogram is incomplete, the colors have to be calculated again
+    histogram_valid_ = false;
+    gradient_positions_max_iterations_ = 0;
+
+    if (resume_from > 0)
+        spdlog::info("supervisor: resuming points that did not escape after {} iterations", resume_from);
+
+    progressive_image_request_.reset();
+
+    if (should_calculate_progressively(image_request, resume_from)) {
+        // the tiles have to be aligned to the coarsest grid so that the preview of a tile only shows its own points
+        image_request.tile_size = (image_request.tile_size + progressive_first_grid_step - 1) / progressive_first_grid_step * progressive_first_grid_step;
+        progressive_image_request_ = image_request;
+        progressive_grid_step_ = progressive_first_grid_step;
+
+        send_calculation_messages(image_request, image_request.area, 0, progressive_grid_step_, false);
+    } else {
+        for (const auto& area : areas)
+            send_calculation_messages(image_request, area, resume_from, 1, skip_even_points);
+    }
+
+    spdlog::trace("supervisor: sent {} Calculate messages", waiting_for_calculation_results_);
 
     status_.set_phase(Phase::Calculating);
 }
@@ -109,18 +234,53 @@ void Supervisor::handle_message(SupervisorCalculationResults&& calculation_resul
 {
     spdlog::debug("supervisor: received message CalculationResults area: {}/{} {}x{}", calculation_results.area.x, calculation_results.area.y, calculation_results.area.width, calculation_results.area.height);
 
+    const auto pixels_size = static_cast<std::size_t>(4 * calculation_results.area.width * calculation_results.area.height);
+
+    if (calculation_results.generation != generation_) {
+        // tile of a canceled calculation, stopped early and incomplete
+        pixel_buffer_pool_.release(std::move(calculation_results.pixels), pixels_size);
+
+        if (--waiting_for_calculation_results_ == 0)
+            finish_cancellation();
+
+        return;
+    }
+
     window_.update_texture(calculation_results.pixels.get(), calculation_results.area);
+    pixel_buffer_pool_.release(std::move(calculation_results.pixels), pixels_size);
+    statistics_.iterations_saved += calculation_results.statistics.iterations_saved;
+    statistics_.rebases += calculation_results.statistics.rebases;
+    statistics_.calculated_points += calculation_results.statistics.calculated_points;
+    statistics_.filled_points += calculation_results.statistics.filled_points;
+    tile_finish_times_.push_back(status_.calculation_time().as_seconds());
+    tile_size_tuner_.add_tile_time(calculation_results.calculation_time);
 
     if (--waiting_for_calculation_results_ == 0) {
-        if (status_.phase() != Phase::Canceled) {
-            // if canceled there is no need to colorize the partial image
-            status_.set_phase(Phase::Coloring);
-            build_iterations_histogram();
-            equalize_histogram(iterations_histogram_, calculation_results.max_iterations, equalized_iterations_);
-            send_colorization_messages(calculation_results.max_iterations, calculation_results.image_size);
-        } else {
-            status_.stop_calculation(Phase::Idle);
+        report_tail_time();
+        tile_size_tuner_.finish_pass();
+
+        if (progressive_image_request_ && progressive_grid_step_ > 1) {
+            spdlog::info("supervisor: progressive pass at 1/{} resolution finished after {:.3f}s", progressive_grid_step_ * progressive_grid_step_, status_.calculation_time().as_seconds());
+
+            // the next pass only calculates the points between the ones that are already known
+            progressive_grid_step_ /= 2;
+            status_.clear_tiles();
+            send_calculation_messages(*progressive_image_request_, progressive_image_request_->area, 0, progressive_grid_step_, true);
+            return;
         }
+
+        spdlog::info("supervisor: interior point detection saved {} iterations", statistics_.iterations_saved);
+
+        if (reference_orbit_)
+            spdlog::info("supervisor: perturbation needed {} reference orbit rebases", statistics_.rebases);
+
+        if (statistics_.filled_points > 0)
+            spdlog::info("supervisor: subdivision filled {} points and calculated {} points", statistics_.filled_points, statistics_.calculated_points);
+
+        status_.set_iterations_saved(statistics_.iterations_saved);
+        status_.set_point_counts(statistics_.calculated_points, statistics_.filled_points);
+
+        colorize_calculated_image(calculation_results.max_iterations, calculation_results.image_size);
     }
 
     assert(waiting_for_calculation_results_ >= 0);
@@ -130,13 +290,24 @@ void Supervisor::handle_message(SupervisorColorizationResults&& colorization_res
 {
     spdlog::debug("supervisor: received message ColorizationResults start_row: {}, num_rows: {}", colorization_results.start_row, colorization_results.num_rows);
 
-    auto data = colorization_results.colorization_buffer->data();
-    std::size_t p = static_cast<std::size_t>(4 * (colorization_results.start_row * colorization_results.row_width));
-    window_.update_texture(&data[p], CalculationArea{0, colorization_results.start_row, colorization_results.row_width, colorization_results.num_rows});
+    if (cancel_clock_) {
+        // colorization canceled by a superseding image request
+        if (--waiting_for_colorization_results_ == 0)
+            finish_cancellation();
 
-    if (--waiting_for_colorization_results_ == 0)
-        if (status_.phase() != Phase::Canceled)
-            status_.stop_calculation(Phase::Idle);
+        return;
+    }
+
+    const auto row_width = static_cast<std::size_t>(colorization_results.row_width);
+    update_texture_from_colorization_buffer(colorization_results.row_width, static_cast<std::size_t>(colorization_results.start_row) * row_width,
+        static_cast<std::size_t>(colorization_results.start_row + colorization_results.num_rows) * row_width);
+
+    if (--waiting_for_colorization_results_ == 0) {
+        log_worker_queue_statistics();
+        log_pixel_buffer_statistics();
+        log_timing_breakdown();
+        status_.stop_calculation(Phase::Idle);
+    }
 
     assert(waiting_for_calculation_results_ >= 0);
 }
@@ -153,20 +324,61 @@ void Supervisor::handle_message(SupervisorColorize&& colorize)
     }
 
     status_.start_calculation(Phase::Coloring);
-    send_colorization_messages(colorize.max_iterations, colorize.image_size);
+    worker_message_queue_.reset_statistics();
+    send_colorization_messages(colorize.max_iterations, colorize.image_size, CalculationArea{0, 0, colorize.image_size.width, colorize.image_size.height});
 }
 
 void Supervisor::handle_message(SupervisorCancel&&)
 {
     spdlog::debug("supervisor: received message Cancel");
 
-    // empty the message queue
-    waiting_for_calculation_results_ -= worker_message_queue_.clear();
+    if (cancel_clock_)
+        return;  // already canceled
 
-    if (waiting_for_calculation_results_ > 0)
-        status_.set_phase(Phase::Canceled); // wait until all workers have finished
+    cancel_running_calculation();
+
+    if (workers_busy())
+        status_.set_phase(Phase::Canceled);  // wait until all workers have stopped
     else
+        finish_cancellation();
+}
+
+// Stop the running calculation or colorization: remove the queued messages and let the workers abort
+// their current tiles by starting a new generation.
+void Supervisor::cancel_running_calculation()
+{
+    cancel_clock_.emplace();
+    ++generation_;
+
+    const int messages_removed = worker_message_queue_.clear();
+
+    if (waiting_for_calculation_results_ > 0) {
+        waiting_for_calculation_results_ -= messages_removed;
+        histogram_valid_ = false;
+
+        // the orbits of the points that have not been calculated are missing
+        resumable_image_request_.reset();
+        progressive_image_request_.reset();
+        image_incomplete_ = true;
+    } else {
+        waiting_for_colorization_results_ -= messages_removed;
+        gradient_positions_max_iterations_ = 0;
+    }
+}
+
+// Called once the workers have returned all canceled tiles.
+void Supervisor::finish_cancellation()
+{
+    spdlog::info("supervisor: cancellation took {:.3f}s until all workers stopped", cancel_clock_->elapsed_time().as_seconds());
+    cancel_clock_.reset();
+
+    if (superseding_image_request_) {
+        SupervisorImageRequest image_request = std::move(*superseding_image_request_);
+        superseding_image_request_.reset();
+        handle_message(std::move(image_request));
+    } else {
         status_.stop_calculation(Phase::Idle);
+    }
 }
 
 void Supervisor::handle_message(SupervisorQuit&&)
@@ -180,14 +392,64 @@ void Supervisor::start_workers()
 {
     spdlog::debug("supervisor: starting workers");
 
+    place_workers();
+
+    std::vector<int> worker_nodes;
+
+    for (const auto& placement : worker_placement_)
+        worker_nodes.push_back(placement.node);
+
     workers_.reserve(static_cast<std::size_t>(num_threads_));
+    worker_message_queue_.set_number_of_workers(num_threads_, worker_nodes);
 
     for (int id = 0; id < num_threads_; ++id) {
-        workers_.emplace_back(id, worker_message_queue_, supervisor_message_queue_);
+        workers_.emplace_back(id, worker_placement_[static_cast<std::size_t>(id)], worker_message_queue_, supervisor_message_queue_);
         workers_.back().run();
     }
 }
 
+void Supervisor::place_workers()
+{
+    if (pin_threads_) {
+        const NumaTopology topology = numa_topology();
+        worker_placement_ = spread_threads(topology, num_threads_);
+        spdlog::info("supervisor: pinning {} workers to the CPUs of {} NUMA node(s)", num_threads_, topology.number_of_nodes());
+    } else {
+        worker_placement_.assign(static_cast<std::size_t>(num_threads_), ThreadPlacement{-1, 0});
+    }
+
+    workers_of_node_.clear();
+
+    for (int id = 0; id < num_threads_; ++id) {
+        const auto node = static_cast<std::size_t>(worker_placement_[static_cast<std::size_t>(id)].node);
+
+        if (workers_of_node_.size() <= node)
+            workers_of_node_.resize(node + 1);
+
+        workers_of_node_[node].push_back(id);
+    }
+
+    next_worker_of_node_.assign(workers_of_node_.size(), 0);
+
+    const bool several_nodes = workers_of_node_.size() > 1;
+    numa_aware_ = several_nodes && worker_message_queue_.scheduler() == Scheduler::WorkStealing;
+
+    if (several_nodes && !numa_aware_)
+        spdlog::info("supervisor: NUMA-aware tile ownership needs the work-stealing scheduler");
+
+    // the buffers were first touched by the previous workers, drop them so that they are allocated again for these
+    if (numa_aware_) {
+        results_per_point_ = CalculationResults{};
+        orbits_per_point_ = OrbitStates{};
+        gradient_positions_ = GradientPositions{};
+        colorization_buffer_ = PixelBuffer{};
+        resumable_image_request_.reset();
+        histogram_valid_ = false;
+    }
+
+    node_of_row_.clear();
+}
+
 void Supervisor::shutdown_workers()
 {
     spdlog::debug("supervisor: signaling workers to stop");
@@ -212,31 +474,362 @@ void Supervisor::clear_message_queues()
     waiting_for_colorization_results_ = 0;
 }
 
-void Supervisor::send_calculation_messages(const SupervisorImageRequest& image_request)
+void Supervisor::log_timing_breakdown()
+{
+    const char* histogram_update = "whole image";
+
+    if (histogram_update_ == HistogramUpdate::FromWorkers)
+        histogram_update = "merged from workers";
+    else if (histogram_update_ == HistogramUpdate::Incremental)
+        histogram_update = "incremental";
+
+    spdlog::info("supervisor: timing breakdown: calculation {:.3f}s, histogram {:.3f}s ({}), equalization {:.3f}s, colorization {:.3f}s",
+        calculation_seconds_, histogram_seconds_, histogram_update, equalization_seconds_, colorization_clock_.elapsed_time().as_seconds());
+}
+
+void Supervisor::log_worker_queue_statistics() const
+{
+    const QueueStatistics statistics = worker_message_queue_.statistics();
+
+    spdlog::info("supervisor: worker queue ({}) had {} contended locks, {} waits, {} steals and {} failed steals",
+        scheduler_name(worker_message_queue_.scheduler()), statistics.contended_locks, statistics.waits, statistics.steals, statistics.failed_steals);
+}
+
+void Supervisor::log_pixel_buffer_statistics() const
+{
+    if (pixel_buffer_pool_.acquired() == 0)
+        return;
+
+    spdlog::info("supervisor: tile previews needed {} buffer allocations for {} tiles (one per tile without reusing buffers), {:.1f} MiB kept for reuse",
+        pixel_buffer_pool_.allocated(), pixel_buffer_pool_.acquired(), static_cast<double>(pixel_buffer_pool_.free_bytes()) / (1024.0 * 1024.0));
+}
+
+// Raising max_iterations does not change any point that already escaped, so all other points can
+// continue from their last orbit point, instead of recalculating the whole image.
+[[nodiscard]] int Supervisor::resume_iterations(const SupervisorImageRequest& image_request) const
+{
+    if (!resumable_image_request_ || should_scroll(image_request))
+        return 0;
+
+    const SupervisorImageRequest& previous = *resumable_image_request_;
+
+    if (image_request.max_iterations <= previous.max_iterations
+        || previous.image_size.width != image_request.image_size.width || previous.image_size.height != image_request.image_size.height
+        || previous.fractal_section != image_request.fractal_section)
+        return 0;
+
+    return previous.max_iterations;
+}
+
+void Supervisor::update_resumable_image_request(const SupervisorImageRequest& image_request)
+{
+    // filled points (subdivision) and double-double calculations do not store their orbits
+    if (image_request.strategy == CalculationStrategy::Subdivision || precision_.precision == Precision::DoubleDouble) {
+        resumable_image_request_.reset();
+        return;
+    }
+
+    // after scrolling or zooming all points are still valid if they have been before, except the deltas of
+    // perturbation after scrolling, which belong to the reference orbit of the previous image center
+    if (should_scroll(image_request) && precision_.precision == Precision::Perturbation) {
+        resumable_image_request_.reset();
+        return;
+    }
+
+    const bool reuses_previous_image = should_scroll(image_request) || image_request.zoom.factor != 1;
+
+    if (!reuses_previous_image || resumable_image_request_)
+        resumable_image_request_ = image_request;
+}
+
+// Progressive calculation first calculates every 4th point in both directions (1/16 of the image), then
+// every 2nd point and finally the remaining points, so that a coarse preview appears almost instantly.
+[[nodiscard]] bool Supervisor::should_calculate_progressively(const SupervisorImageRequest& image_request, const int resume_iterations) const
+{
+    return image_request.strategy == CalculationStrategy::Progressive && resume_iterations == 0 && !should_scroll(image_request) && image_request.zoom.factor == 1;
+}
+
+// Split the area into tiles and sort them by the tile order. The costs have to be estimated
+// before the first tile is sent, because the workers overwrite results_per_point_.
+[[nodiscard]] std::vector<CalculationArea> Supervisor::ordered_tiles(const SupervisorImageRequest& image_request, const CalculationArea& area, const int grid_step, const bool skip_coarser_grid)
+{
+    auto cost = [&](const CalculationArea& tile) { return estimated_tile_cost(tile); };
+
+    std::vector<CalculationArea> tiles = image_request.adaptive_tile_size
+        ? tile_size_tuner_.tiles(area, image_request.tile_size, num_threads_, cost)
+        : fixed_size_tiles(area, image_request.tile_size);
+
+    // the tuner learns the time per cost of a fully calculated tile, passes on a grid only calculate a part of its points
+    const double points_calculated = skip_coarser_grid ? 1.0 / (grid_step * grid_step) - 1.0 / (4 * grid_step * grid_step) : 1.0 / (grid_step * grid_step);
+
+    for (const auto& tile : tiles)
+        tile_size_tuner_.add_sent_cost(points_calculated * static_cast<double>(cost(tile)));
+
+    if (tile_order_ == TileOrder::CostFirst) {
+        std::vector<std::pair<std::int64_t, CalculationArea>> costs;
+        costs.reserve(tiles.size());
+
+        for (const auto& tile : tiles)
+            costs.emplace_back(cost(tile), tile);
+
+        // tiles with the same cost (e.g. all of them after a resize) keep their row-major order
+        std::stable_sort(costs.begin(), costs.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        for (std::size_t i = 0; i < tiles.size(); ++i)
+            tiles[i] = costs[i].second;
+    } else if (tile_order_ == TileOrder::CenterOut) {
+        const int center_x = image_request.image_size.width / 2;
+        const int center_y = image_request.image_size.height / 2;
+
+        auto distance_to_center = [&](const CalculationArea& tile) {
+            const std::int64_t dx = tile.x + tile.width / 2 - center_x;
+            const std::int64_t dy = tile.y + tile.height / 2 - center_y;
+            return dx * dx + dy * dy;
+        };
+
+        std::stable_sort(tiles.begin(), tiles.end(), [&](const auto& a, const auto& b) { return distance_to_center(a) < distance_to_center(b); });
+    }
+
+    return tiles;
+}
+
+// The iterations of the previous image in results_per_point_ are a good estimate of the work
+// needed for a tile, as long as the image has only been scrolled, zoomed or recalculated with
+// different parameters. Every 4th point in both directions is enough for this. The points that
+// were scrolled in or are around a zoomed out image are stale, they take the nearest known point,
+// i.e. a strip is estimated from the edge of the image next to it.
+[[nodiscard]] std::int64_t Supervisor::estimated_tile_cost(const CalculationArea& tile) const
 {
-    for (int y = image_request.area.y; y < (image_request.area.y + image_request.area.height); y += image_request.tile_size) {
-        const int height = std::min(image_request.area.y + image_request.area.height - y, image_request.tile_size);
+    constexpr int sample_step = 4;
+    const CalculationArea& known = known_points_area_;
+    std::int64_t cost = 0;
 
-        for (int x = image_request.area.x; x < (image_request.area.x + image_request.area.width); x += image_request.tile_size) {
-            const int width = std::min(image_request.area.x + image_request.area.width - x, image_request.tile_size);
-            worker_message_queue_.send(WorkerCalculate{
-                image_request.max_iterations, image_request.image_size, {x, y, width, height},
-                image_request.fractal_section, &results_per_point_,
-                std::make_unique<sf::Uint8[]>(static_cast<std::size_t>(4 * width * height))
-            });
+    for (int y = tile.y; y < tile.y + tile.height; y += sample_step) {
+        const int known_y = std::clamp(y, known.y, known.y + known.height - 1);
 
-            ++waiting_for_calculation_results_;
+        for (int x = tile.x; x < tile.x + tile.width; x += sample_step)
+            cost += results_per_point_.iter(result_layout_.index(std::clamp(x, known.x, known.x + known.width - 1), known_y)) + 1;
+    }
+
+    return cost;
+}
+
+// Tail time: how long the last tile took to finish after half of the tiles were done.
+void Supervisor::report_tail_time()
+{
+    if (tile_finish_times_.empty())
+        return;
+
+    std::sort(tile_finish_times_.begin(), tile_finish_times_.end());
+
+    const float median = tile_finish_times_[tile_finish_times_.size() / 2];
+    const float last = tile_finish_times_.back();
+
+    spdlog::info("supervisor: {} tiles ({} order), median finished after {:.3f}s, last after {:.3f}s, tail time {:.3f}s",
+        tile_finish_times_.size(), tile_order_name(tile_order_), median, last, last - median);
+
+    status_.set_tail_time(last - median);
+    tile_finish_times_.clear();
+}
+
+void Supervisor::send_calculation_messages(const SupervisorImageRequest& image_request, const CalculationArea& area, const int resume_iterations, const int grid_step, const bool skip_coarser_grid)
+{
+    std::vector<CalculationArea> tiles = ordered_tiles(image_request, area, grid_step, skip_coarser_grid);
+    status_.add_tiles(tiles);
+
+    // each work-stealing deque hands its newest tile to its worker first, so the tiles are sent in reverse
+    // order to keep e.g. the most expensive ones first (thieves take the cheap ones from the other end)
+    if (worker_message_queue_.scheduler() == Scheduler::WorkStealing)
+        std::reverse(tiles.begin(), tiles.end());
+
+    for (const auto& tile : tiles) {
+        worker_message_queue_.send(WorkerCalculate{
+            image_request.max_iterations, image_request.image_size, tile,
+            image_request.fractal_section, image_request.strategy, kernel_, precision_.precision, reference_orbit_,
+            resume_iterations, grid_step, skip_coarser_grid, generation_, &generation_, histogram_update_ != HistogramUpdate::WholeImage && grid_step == 1,
+            provisional_equalized_iterations(image_request), &gradient_, &results_per_point_, &orbits_per_point_, result_layout_,
+            pixel_buffer_pool_.acquire(static_cast<std::size_t>(4 * tile.width * tile.height))
+        }, preferred_worker(tile.y + tile.height / 2));
+
+        ++waiting_for_calculation_results_;
+    }
+}
+
+void Supervisor::update_precision(const SupervisorImageRequest& image_request)
+{
+    PrecisionChoice precision = choose_precision(image_request.image_size, image_request.fractal_section, image_request.max_iterations);
+
+    if (precision.precision != precision_.precision)
+        spdlog::info("supervisor: switching to {} precision ({})", precision_name(precision.precision), precision.reason);
+
+    precision_ = std::move(precision);
+    status_.set_precision(precision_);
+}
+
+void Supervisor::update_reference_orbit(const SupervisorImageRequest& image_request)
+{
+    if (precision_.precision != Precision::Perturbation) {
+        reference_orbit_.reset();
+        return;
+    }
+
+    const int fraction_limbs = required_fraction_limbs(image_request.image_size, image_request.fractal_section);
+
+    // the reference orbit can be reused as long as the image center stays the same (for example when zooming)
+    if (reference_orbit_ && reference_orbit_->center_x == image_request.fractal_section.center_x && reference_orbit_->center_y == image_request.fractal_section.center_y
+        && reference_orbit_->max_iterations == image_request.max_iterations && reference_orbit_->fraction_limbs >= fraction_limbs)
+        return;
+
+    Stopwatch stopwatch;
+    stopwatch.start();
+
+    reference_orbit_ = std::make_shared<const ReferenceOrbit>(calculate_reference_orbit(image_request.fractal_section, image_request.max_iterations, fraction_limbs));
+
+    spdlog::info("supervisor: calculated reference orbit with {} iterations at {} bits precision in {:.3f}s",
+        std::ssize(reference_orbit_->x) - 1, 32 * fraction_limbs, stopwatch.time().as_seconds());
+}
+
+// The equalized iterations of the previous image are a good approximation while the image is calculated,
+// if max_iterations has not changed. They are only replaced after all tiles have been calculated.
+[[nodiscard]] const std::vector<float>* Supervisor::provisional_equalized_iterations(const SupervisorImageRequest& image_request) const
+{
+    if (!image_request.pipelined_colorization || equalized_max_iterations_ != image_request.max_iterations)
+        return nullptr;
+
+    return &equalized_iterations_;
+}
+
+// Equalizes the histogram of the current image and returns by how much the new equalized iterations differ
+// from the reference (the previous ones or those of the last recolor), in the range of the positions in the
+// gradient 0.0 .. 1.0.
+[[nodiscard]] float Supervisor::update_equalized_iterations(const int max_iterations, const std::vector<float>& reference)
+{
+    std::vector<float> equalized_iterations(equalized_iterations_.size());
+    equalize_histogram(iterations_histogram_, max_iterations, equalized_iterations);
+
+    float max_difference = reference.size() == equalized_iterations.size() ? 0.0f : std::numeric_limits<float>::infinity();
+
+    for (std::size_t i = 0; i < equalized_iterations.size() && i < reference.size(); ++i)
+        max_difference = std::max(max_difference, std::abs(equalized_iterations[i] - reference[i]));
+
+    equalized_iterations_.swap(equalized_iterations);
+    equalized_max_iterations_ = max_iterations;
+
+    return max_difference / static_cast<float>(max_iterations);
+}
+
+void Supervisor::colorize_calculated_image(const int max_iterations, const ImageSize& image_size)
+{
+    calculation_seconds_ = status_.calculation_time().as_seconds();
+
+    Clock clock;
+    build_iterations_histogram();
+    histogram_seconds_ = clock.restart().as_seconds();
+
+    if (image_colorized_provisionally_) {
+        const float max_difference = update_equalized_iterations(max_iterations, equalized_iterations_);
+        equalization_seconds_ = clock.restart().as_seconds();
+
+        if (max_difference < recolor_threshold) {
+            spdlog::info("supervisor: provisional colors differ by at most {:.5f}, skipping the final recolor", max_difference);
+            colorization_clock_.restart();
+            log_worker_queue_statistics();
+            log_pixel_buffer_statistics();
+            log_timing_breakdown();
+            status_.stop_calculation(Phase::Idle);
+            return;
+        }
+
+        spdlog::info("supervisor: provisional colors differ by up to {:.5f}, recoloring", max_difference);
+    } else if (scrolled_image_request_ && scrolled_colors_complete_) {
+        // the colors that are only moved have the equalization of the last recolor, so the differences of
+        // several scrolls in a row must not add up
+        const float max_difference = update_equalized_iterations(max_iterations, recolored_equalized_iterations_);
+        equalization_seconds_ = clock.restart().as_seconds();
+
+        if (max_difference < recolor_threshold) {
+            ++strip_recolors_;
+            spdlog::info("supervisor: colors after scrolling differ by at most {:.5f}, colorizing only the new strip ({} strip, {} full recolors)", max_difference, strip_recolors_, full_recolors_);
+
+            colorization_clock_.restart();
+            status_.set_phase(Phase::Coloring);
+            colorize_scrolled_strip(max_iterations, *scrolled_image_request_);
+            return;
+        }
+
+        ++full_recolors_;
+        spdlog::info("supervisor: colors after scrolling differ by up to {:.5f}, recoloring ({} strip, {} full recolors)", max_difference, strip_recolors_, full_recolors_);
+    } else {
+        if (scrolled_image_request_) {
+            ++full_recolors_;
+            spdlog::info("supervisor: colors of the previous image are incomplete, recoloring after scrolling ({} strip, {} full recolors)", strip_recolors_, full_recolors_);
         }
+
+        equalize_histogram(iterations_histogram_, max_iterations, equalized_iterations_);
+        equalized_max_iterations_ = max_iterations;
+        equalization_seconds_ = clock.restart().as_seconds();
     }
 
-    spdlog::trace("supervisor: sent {} Calculate messages", waiting_for_calculation_results_);
+    colorization_clock_.restart();
+    status_.set_phase(Phase::Coloring);
+    send_colorization_messages(max_iterations, image_size, CalculationArea{0, 0, image_size.width, image_size.height});
+}
+
+// Colorizes only the strip that was scrolled in, the colors and gradient positions of the previous image have
+// already moved along with pixel_origin_. The rows outside of the strip are complete at once, the workers send the others.
+void Supervisor::colorize_scrolled_strip(const int max_iterations, const SupervisorImageRequest& image_request)
+{
+    const ImageSize& image_size = image_request.image_size;
+    const CalculationArea& strip = image_request.area;
+
+    if (strip.height < image_size.height) {
+        const auto row_width = static_cast<std::size_t>(image_size.width);
+        const std::size_t start_row = strip.y == 0 ? static_cast<std::size_t>(strip.height) : 0;
+        update_texture_from_colorization_buffer(image_size.width, start_row * row_width, start_row * row_width + static_cast<std::size_t>(image_size.height - strip.height) * row_width);
+    }
+
+    send_colorization_messages(max_iterations, image_size, strip);
+}
+
+// Uploads the pixels [begin, end) of the image (row by row) to the texture. They wrap around at the end of
+// colorization_buffer_, each contiguous part is uploaded as up to three rectangles: the rest of a row, whole rows
+// and the start of a row.
+void Supervisor::update_texture_from_colorization_buffer(const int row_width, std::size_t begin, const std::size_t end)
+{
+    const auto width = static_cast<std::size_t>(row_width);
+    const std::size_t buffer_size = colorization_buffer_.size() / 4;
+
+    while (begin < end) {
+        const std::size_t pixels = (pixel_origin_ + begin) % buffer_size;
+        std::size_t part_end = std::min(end, begin + (buffer_size - pixels));
+
+        if (begin % width != 0)
+            part_end = std::min(part_end, (begin / width + 1) * width);
+        else if (part_end - begin >= width)
+            part_end = begin + (part_end - begin) / width * width;
+
+        const bool whole_rows = begin % width == 0 && part_end - begin >= width;
+        const int x = static_cast<int>(begin % width);
+        const int y = static_cast<int>(begin / width);
+        const int count = static_cast<int>(part_end - begin);
+
+        window_.update_texture(colorization_buffer_.data() + 4 * pixels, whole_rows ? CalculationArea{0, y, row_width, count / row_width} : CalculationArea{x, y, count, 1});
+        begin = part_end;
+    }
 }
 
-void Supervisor::send_colorization_messages(const int max_iterations, const ImageSize& image_size)
+// Splits the rows of the area into one band per worker.
+void Supervisor::send_colorization_messages(const int max_iterations, const ImageSize& image_size, const CalculationArea& area)
 {
-    const int min_rows_per_thread = image_size.height / static_cast<int>(std::ssize(workers_));
-    int extra_rows = image_size.height % std::ssize(workers_);
-    int next_start_row = 0;
+    // if only the gradient has changed since the last colorization, its positions in the gradient are still valid
+    const bool lookup_only = gradient_positions_max_iterations_ == max_iterations && std::ssize(gradient_positions_) == image_size.width * image_size.height;
+
+    if (lookup_only)
+        spdlog::debug("supervisor: reusing the gradient positions, colorizing by color lookups only");
+
+    const int min_rows_per_thread = area.height / static_cast<int>(std::ssize(workers_));
+    int extra_rows = area.height % std::ssize(workers_);
+    int next_start_row = area.y;
 
     for (int i = 0; i < std::ssize(workers_); ++i) {
         const int start_row = next_start_row;
@@ -247,16 +840,25 @@ void Supervisor::send_colorization_messages(const int max_iterations, const Imag
             --extra_rows;
         }
 
+        if (num_rows == 0)
+            break;  // a strip with fewer rows than workers
+
         next_start_row = start_row + num_rows;
 
         worker_message_queue_.send(WorkerColorize{
-            max_iterations, start_row, num_rows, image_size.width, &gradient_,
-            &results_per_point_, &equalized_iterations_, &colorization_buffer_
-        });
+            max_iterations, start_row, num_rows, area.x, area.width, image_size.width, pixel_origin_, kernel_, &gradient_,
+            &results_per_point_, result_layout_, &equalized_iterations_, &gradient_positions_, lookup_only, &colorization_buffer_
+        }, preferred_worker(start_row));
 
         ++waiting_for_colorization_results_;
     }
 
+    // valid once the workers are done, unless the colorization is canceled
+    gradient_positions_max_iterations_ = max_iterations;
+
+    if (!lookup_only && area.width == image_size.width && area.height == image_size.height)
+        recolored_equalized_iterations_ = equalized_iterations_;
+
     spdlog::trace("supervisor: sent {} Colorize messages", waiting_for_colorization_results_);
 }
 
@@ -264,15 +866,22 @@ bool Supervisor::resize_and_reset_buffers_if_needed(const ImageSize& image_size,
 {
     bool recalculation_needed = false;
 
-    if (std::ssize(results_per_point_) != (image_size.width * image_size.height) || std::ssize(colorization_buffer_) != (4 * image_size.width * image_size.height)) {
-        results_per_point_.resize(static_cast<std::size_t>(image_size.width * image_size.height));
-        colorization_buffer_.resize(static_cast<std::size_t>(4 * image_size.width * image_size.height));
+    if (!result_layout_.has_shape(result_order_, image_size) || results_per_point_.size() != result_layout_.size() || std::ssize(colorization_buffer_) != (4 * image_size.width * image_size.height)) {
+        allocate_buffers(image_size, max_iterations);
         recalculation_needed = true;
+    } else if (results_per_point_.reserve_iterations(max_iterations)) {
+        // the workers copy the iterations of their rows, so that the pages of the wider plane stay on their nodes
+        send_first_touch_messages(image_size, true);
+        results_per_point_.finish_widening();
+        spdlog::debug("supervisor: widened the iterations of the calculation results to {} bits", results_per_point_.iteration_bits());
+        log_buffer_memory(image_size);
     }
 
     if (std::ssize(iterations_histogram_) != max_iterations + 1 || std::ssize(equalized_iterations_) != max_iterations + 1) {
         iterations_histogram_.resize(static_cast<std::size_t>(max_iterations + 1));
         equalized_iterations_.resize(static_cast<std::size_t>(max_iterations + 1));
+        equalized_max_iterations_ = 0;
+        histogram_valid_ = false;
         recalculation_needed = true;
     }
 
@@ -287,9 +896,97 @@ bool Supervisor::resize_and_reset_buffers_if_needed(const ImageSize& image_size,
     return recalculation_needed;
 }
 
+// The buffers are allocated without initializing them, every worker zeroes a band of rows. That way each memory
+// page is first touched by, and placed on the NUMA node of, a worker that later calculates and colorizes these rows.
+void Supervisor::allocate_buffers(const ImageSize& image_size, const int max_iterations)
+{
+    Clock clock;
+    result_layout_ = ResultLayout{result_order_, image_size};
+
+    // new vectors instead of resize(), which would copy the old points into the new memory on this thread
+    results_per_point_ = CalculationResults(result_layout_.size(), compact_results_, max_iterations);
+    orbits_per_point_ = OrbitStates(result_layout_.size());
+    gradient_positions_ = GradientPositions(static_cast<std::size_t>(image_size.width * image_size.height));
+    colorization_buffer_ = PixelBuffer(static_cast<std::size_t>(4 * image_size.width * image_size.height));
+    pixel_origin_ = 0;
+    gradient_positions_max_iterations_ = 0;
+
+    send_first_touch_messages(image_size, false);
+
+    spdlog::debug("supervisor: workers initialized the buffers of {} points in {:.3f}s", result_layout_.size(), clock.elapsed_time().as_seconds());
+    log_buffer_memory(image_size);
+}
+
+// Every worker initializes (or widens the iterations of) a band of rows of the buffers and waits until all are done.
+void Supervisor::send_first_touch_messages(const ImageSize& image_size, const bool widen_iterations)
+{
+    // the workers of a node get consecutive bands, so that every node owns one part of the image
+    std::vector<int> owners(workers_.size());
+    std::iota(owners.begin(), owners.end(), 0);
+    std::stable_sort(owners.begin(), owners.end(), [&](const int a, const int b) {
+        return worker_placement_[static_cast<std::size_t>(a)].node < worker_placement_[static_cast<std::size_t>(b)].node;
+    });
+
+    node_of_row_.assign(static_cast<std::size_t>(image_size.height), 0);
+    std::latch done{std::ssize(owners)};
+
+    // bands of whole tile rows, so that they are contiguous in the tile-major layout as well
+    const int tile_rows = (image_size.height + ResultLayout::tile_size - 1) / ResultLayout::tile_size;
+    const auto band_start = [&](const int band) {
+        return std::min(image_size.height, static_cast<int>(std::int64_t{tile_rows} * band / std::ssize(owners)) * ResultLayout::tile_size);
+    };
+
+    for (int i = 0; i < std::ssize(owners); ++i) {
+        const int worker = owners[static_cast<std::size_t>(i)];
+        const int start_row = band_start(i);
+        const int end_row = band_start(i + 1);
+
+        std::fill(node_of_row_.begin() + start_row, node_of_row_.begin() + end_row, worker_placement_[static_cast<std::size_t>(worker)].node);
+
+        worker_message_queue_.send_to(WorkerFirstTouch{
+            start_row, end_row - start_row, image_size.width, widen_iterations,
+            &results_per_point_, &orbits_per_point_, result_layout_, &gradient_positions_, &colorization_buffer_, &done
+        }, worker);
+    }
+
+    done.wait();
+}
+
+// Bytes per pixel of each per point buffer (padding of the tile-major layout included) and their total.
+void Supervisor::log_buffer_memory(const ImageSize& image_size) const
+{
+    const auto pixels = static_cast<double>(image_size.width) * static_cast<double>(image_size.height);
+    const double results = static_cast<double>(results_per_point_.size() * results_per_point_.bytes_per_point());
+    const double orbits = static_cast<double>(orbits_per_point_.size() * sizeof(OrbitState));
+    const double positions = static_cast<double>(gradient_positions_.size() * sizeof(float));
+    const double colorization = static_cast<double>(colorization_buffer_.size());
+    const double render = 4.0 * pixels;
+    const double tile_previews = static_cast<double>(pixel_buffer_pool_.free_bytes());
+    const double total = results + orbits + positions + colorization + render + tile_previews;
+
+    const std::string results_format = results_per_point_.compact() ? fmt::format("compact, {} bit iterations", results_per_point_.iteration_bits()) : "array of structures";
+
+    spdlog::info("supervisor: buffer memory per pixel: results {:.2f} bytes ({}), orbits {:.2f} bytes, gradient positions {:.2f} bytes, colorization {:.2f} bytes, render buffer {:.2f} bytes, tile preview pool {:.2f} bytes, total {:.2f} bytes ({:.1f} MiB)",
+        results / pixels, results_format, orbits / pixels, positions / pixels, colorization / pixels, render / pixels, tile_previews / pixels, total / pixels, total / (1024.0 * 1024.0));
+}
+
+// A worker on the NUMA node that owns the row (round-robin), -1 to let the queue distribute the message.
+[[nodiscard]] int Supervisor::preferred_worker(const int row)
+{
+    if (!numa_aware_ || row < 0 || row >= std::ssize(node_of_row_))
+        return -1;
+
+    // the rows were first touched before any scrolling, the nodes belong to the rows of the buffers
+    const auto node = static_cast<std::size_t>(node_of_row_[static_cast<std::size_t>(result_layout_.buffer_row(row))]);
+    const auto& workers = workers_of_node_[node];
+
+    return workers[next_worker_of_node_[node]++ % workers.size()];
+}
+
 void Supervisor::modify_image_request_for_recalculation(SupervisorImageRequest& image_request) const
 {
     image_request.scroll = Scroll{0, 0};
+    image_request.zoom = Zoom{1, false};
     image_request.area = CalculationArea{0, 0, image_request.image_size.width, image_request.image_size.height};
 }
 
@@ -298,57 +995,139 @@ void Supervisor::modify_image_request_for_recalculation(SupervisorImageRequest&
     return image_request.scroll.x != 0 || image_request.scroll.y != 0;
 }
 
-void Supervisor::scroll_results_per_point_array(const SupervisorImageRequest& image_request)
+[[nodiscard]] bool Supervisor::should_zoom(const SupervisorImageRequest& image_request) const
 {
-    assert(image_request.scroll.x != 0 || image_request.scroll.y != 0);
+    if (image_request.zoom.factor != 2 || image_request.image_size.width % 4 != 0 || image_request.image_size.height % 4 != 0 || !image_fractal_section_)
+        return false;
 
-    const int dx = image_request.scroll.x;
-    const int dy = image_request.scroll.y;
+    // after zooming by factor 2 about the same center every other point lies exactly on a point of the previous image
+    const FractalSection& section = image_request.fractal_section;
+    const double previous_height = image_request.zoom.out ? section.height / 2.0 : section.height * 2.0;
 
-    if (dy < 0) {
-        for (int y = image_request.image_size.height - 1; y >= 0; --y)
-            copy_results_per_point_row(dx, dy, image_request.image_size.width, image_request.image_size.height, y);
-    } else {
-        for (int y = 0; y < image_request.image_size.height; ++y)
-            copy_results_per_point_row(dx, dy, image_request.image_size.width, image_request.image_size.height, y);
-    }
+    return *image_fractal_section_ == FractalSection{section.center_x, section.center_y, previous_height};
 }
 
-void Supervisor::copy_results_per_point_row(const int dx, const int dy, const int image_width, const int image_height, const int y)
+// Coordinates (rows or columns) of the points that are moved when zooming by factor 2 about the center of
+// size points. Zooming in moves the old point p to 2 * p - size / 2, zooming out moves the old point
+// 2 * p - size / 2 to p. To copy the points in place those farthest from the center must be moved first
+// when zooming in and those closest to the center when zooming out.
+[[nodiscard]] std::vector<int> zoom_move_order(const int size, const bool out)
 {
-    if (dx < 0) {
-        for (int x = image_width - 1; x >= 0; --x) {
-            const int dstx = x - dx;
-            const int dsty = y - dy;
+    const int center = size / 2;
+    std::vector<int> order(static_cast<std::size_t>(size / 2));
+    std::iota(order.begin(), order.end(), size / 4);
 
-            if (dstx >= 0 && dstx < image_width && dsty >= 0 && dsty < image_height) {
-                auto src = results_per_point_.begin() + (y * image_width + x);
-                auto dst = results_per_point_.begin() + (dsty * image_width + dstx);
-                *dst = *src;
-            }
-        }
-    } else {
-        for (int x = 0; x < image_width; ++x) {
-            const int dstx = x - dx;
-            const int dsty = y - dy;
-
-            if (dstx >= 0 && dstx < image_width && dsty >= 0 && dsty < image_height) {
-                auto src = results_per_point_.begin() + (y * image_width + x);
-                auto dst = results_per_point_.begin() + (dsty * image_width + dstx);
-                *dst = *src;
-            }
+    std::stable_sort(order.begin(), order.end(), [&](const int a, const int b) {
+        return out ? std::abs(a - center) < std::abs(b - center) : std::abs(a - center) > std::abs(b - center);
+    });
+
+    return order;
+}
+
+void Supervisor::zoom_results_per_point_array(const SupervisorImageRequest& image_request)
+{
+    assert(should_zoom(image_request));
+
+    const int width = image_request.image_size.width;
+    const int height = image_request.image_size.height;
+    const bool out = image_request.zoom.out;
+
+    const auto columns = zoom_move_order(width, out);
+
+    for (const int y : zoom_move_order(height, out)) {
+        const int src_y = out ? 2 * y - height / 2 : y;
+        const int dst_y = out ? y : 2 * y - height / 2;
+
+        for (const int x : columns) {
+            const int src_x = out ? 2 * x - width / 2 : x;
+            const int dst_x = out ? x : 2 * x - width / 2;
+
+            const auto src = result_layout_.index(src_x, src_y);
+            const auto dst = result_layout_.index(dst_x, dst_y);
+            results_per_point_.set(dst, results_per_point_.get(src));
+            orbits_per_point_[dst] = orbits_per_point_[src];
         }
     }
 }
 
+// After zooming out by factor 2 the previous image covers the center, everything around it is missing.
+[[nodiscard]] std::vector<CalculationArea> Supervisor::areas_around_zoomed_out_image(const ImageSize& image_size) const
+{
+    const int border_x = image_size.width / 4;
+    const int border_y = image_size.height / 4;
+
+    return {
+        {0, 0, image_size.width, border_y},
+        {0, image_size.height - border_y, image_size.width, border_y},
+        {0, border_y, border_x, image_size.height - 2 * border_y},
+        {image_size.width - border_x, border_y, border_x, image_size.height - 2 * border_y},
+    };
+}
+
+// The per point buffers are a ring buffer, so scrolling only moves their origin. The points that are scrolled
+// off the image take the place of the strip that is scrolled in, which is calculated next.
+void Supervisor::scroll_results_per_point_array(const SupervisorImageRequest& image_request)
+{
+    assert(image_request.scroll.x != 0 || image_request.scroll.y != 0);
+
+    result_layout_.scroll(image_request.scroll.x, image_request.scroll.y);
+
+    // the pixels move along in their ring buffer, the ones that wrap into the next or previous row are in the
+    // scrolled in strip and colorized again
+    const auto size = static_cast<std::int64_t>(gradient_positions_.size());
+    const std::int64_t shift = static_cast<std::int64_t>(image_request.scroll.y) * image_request.image_size.width + image_request.scroll.x;
+    pixel_origin_ = static_cast<std::size_t>(((static_cast<std::int64_t>(pixel_origin_) + shift) % size + size) % size);
+}
+
 void Supervisor::build_iterations_histogram()
 {
-    // set histogram back to 0
-    std::fill(iterations_histogram_.begin(), iterations_histogram_.end(), 0);
+    // set histogram back to 0, unless only the points of the new tiles are missing
+    if (histogram_update_ != HistogramUpdate::Incremental)
+        std::fill(iterations_histogram_.begin(), iterations_histogram_.end(), 0);
+
+    if (histogram_update_ != HistogramUpdate::WholeImage) {
+        // the workers have counted the points of their tiles
+        for (const auto& worker : workers_) {
+            if (const std::vector<int>* histogram = worker.iterations_histogram(generation_)) {
+                assert(histogram->size() == iterations_histogram_.size());
+                std::transform(iterations_histogram_.begin(), iterations_histogram_.end(), histogram->begin(), iterations_histogram_.begin(), std::plus<int>{});
+            }
+        }
+    } else {
+        for (std::size_t i = 0; i < results_per_point_.size(); ++i)
+            ++iterations_histogram_[static_cast<std::size_t>(results_per_point_.iter(i))];
 
-    for (const auto& point : results_per_point_)
-        ++iterations_histogram_[point.iter];
+        // the padding points of the tile-major layout are zero
+        iterations_histogram_[0] -= static_cast<int>(result_layout_.padding_points());
+    }
 
     // [max_iterations] must be zero (as we do not count the iterations of the points inside the Mandelbrot Set)
     iterations_histogram_.back() = 0;
+    histogram_valid_ = true;
+}
+
+// Before the results are moved by scrolling, remove the points that will be scrolled off the image from the
+// histogram. Together with the points of the newly calculated strip, this keeps the histogram up to date
+// with work proportional to the size of the strip instead of the image.
+void Supervisor::remove_scrolled_off_points_from_histogram(const SupervisorImageRequest& image_request)
+{
+    const int width = image_request.image_size.width;
+    const int height = image_request.image_size.height;
+    const int dx = image_request.scroll.x;
+    const int dy = image_request.scroll.y;
+
+    // a point at x, y moves to x - dx, y - dy
+    auto remove_points = [&](const int y, const int x_begin, const int x_end) {
+        for (int x = x_begin; x < x_end; ++x)
+            --iterations_histogram_[static_cast<std::size_t>(results_per_point_.iter(result_layout_.index(x, y)))];
+    };
+
+    for (int y = 0; y < height; ++y) {
+        if (y - dy < 0 || y - dy >= height)
+            remove_points(y, 0, width);
+        else if (dx > 0)
+            remove_points(y, 0, std::min(dx, width));
+        else if (dx < 0)
+            remove_points(y, std::max(0, width + dx), width);
+    }
 }
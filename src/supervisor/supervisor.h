@@ -1,15 +1,26 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <thread>
 #include <vector>
 
 #include <SFML/Graphics/Color.hpp>
 #include <SFML/Graphics/Image.hpp>
 
+#include "pixel_buffer_pool.h"
 #include "supervisor_status.h"
+#include "clock/clock.h"
+#include "tile_order.h"
+#include "tile_size_tuner.h"
 #include "gradient/gradient.h"
+#include "mandelbrot/kernel.h"
+#include "mandelbrot/precision.h"
 #include "messages/message_queue.h"
 #include "messages/messages.h"
+#include "messages/worker_queue.h"
 #include "window/window.h"
 #include "worker/worker.h"
 
@@ -26,22 +37,110 @@ class Supervisor {
     int num_threads_;
     std::thread thread_;
 
+    Kernel kernel_;
+    TileOrder tile_order_;
+
     std::vector<Worker> workers_;
 
+    // NUMA-aware tile ownership: with pinned workers on several nodes and the work-stealing scheduler, the
+    // tiles and colorization rows go to workers of the node on which the rows were first touched
+    bool pin_threads_;
+    bool numa_aware_ = false;
+    std::vector<ThreadPlacement> worker_placement_;
+    std::vector<std::vector<int>> workers_of_node_;
+    std::vector<std::size_t> next_worker_of_node_;
+    std::vector<int> node_of_row_;  // per row of the buffers
+
+    bool compact_results_;
+
     Window& window_;
 
     Gradient gradient_;
 
-    MessageQueue<WorkerMessage> worker_message_queue_;
+    WorkerQueue worker_message_queue_;
     MessageQueue<SupervisorMessage> supervisor_message_queue_;
 
     int waiting_for_calculation_results_ = 0;
     int waiting_for_colorization_results_ = 0;
 
+    // incremented to cancel the running calculation, the workers stop their tiles at the next row
+    std::atomic<std::uint64_t> generation_ = 0;
+
+    // image request that supersedes the canceled calculation, handled as soon as all workers have stopped
+    std::optional<SupervisorImageRequest> superseding_image_request_;
+
+    // started by a cancellation, to log how long it takes until all workers have stopped
+    std::optional<Clock> cancel_clock_;
+
+    // a canceled calculation leaves an incomplete image that must not be reused by scrolling, zooming or resuming
+    bool image_incomplete_ = false;
+
+    // fractal section of the image in the per point buffers, zooming only reuses points of exactly this section
+    std::optional<FractalSection> image_fractal_section_;
+
+    CalculationStatistics statistics_{};
+
+    PrecisionChoice precision_{Precision::Double, {}};
+    std::shared_ptr<const ReferenceOrbit> reference_orbit_;
+
     std::vector<int> iterations_histogram_;
-    std::vector<CalculationResult> results_per_point_;
+    ResultOrder result_order_;
+    ResultLayout result_layout_;  // of results_per_point_ and orbits_per_point_
+    CalculationResults results_per_point_;
+    OrbitStates orbits_per_point_;
+
+    // last image request for which orbits_per_point_ holds the state of all points that did not escape
+    std::optional<SupervisorImageRequest> resumable_image_request_;
+
+    // image request that is being calculated progressively and the grid step of its current pass
+    static constexpr int progressive_first_grid_step = 4;
+    std::optional<SupervisorImageRequest> progressive_image_request_;
+    int progressive_grid_step_ = 1;
+
+    // seconds since the start of the calculation at which the tiles of the current pass finished
+    std::vector<float> tile_finish_times_;
+
+    TileSizeTuner tile_size_tuner_;
+    CalculationArea known_points_area_;  // points of the previous image still in place after scrolling or zooming out, for the cost estimates
+    PixelBufferPool pixel_buffer_pool_;
+
     std::vector<float> equalized_iterations_;
-    std::vector<sf::Uint8> colorization_buffer_;
+
+    // pipelined colorization: tiles are colorized with the equalized iterations of the previous image, the final
+    // recolor is skipped if the tiles covered the whole image and the exact distribution differs less than this
+    static constexpr float recolor_threshold = 1.0f / 1024.0f;
+    int equalized_max_iterations_ = 0;  // max_iterations of equalized_iterations_, 0 if not calculated yet
+    bool image_colorized_provisionally_ = false;
+
+    // after scrolling, the colors of the previous image are moved along and only the new strip is colorized, unless
+    // the previous colors are incomplete or the equalization has changed by at least recolor_threshold
+    std::optional<SupervisorImageRequest> scrolled_image_request_;
+    bool scrolled_colors_complete_ = false;
+    std::vector<float> recolored_equalized_iterations_;  // of the last colorization of the whole image, the reference for the strips
+    int strip_recolors_ = 0;  // how often the colorization after scrolling was limited to the strip
+    int full_recolors_ = 0;
+
+    // How build_iterations_histogram gets the histogram of the current image: by walking all points, by adding
+    // up the histograms of the workers if their tiles cover the whole image or, after scrolling, by adding the
+    // histograms of the workers (for the new strip) to the previous histogram without the points scrolled off.
+    enum class HistogramUpdate {
+        WholeImage,
+        FromWorkers,
+        Incremental,
+    };
+
+    HistogramUpdate histogram_update_ = HistogramUpdate::WholeImage;
+    bool histogram_valid_ = false;  // iterations_histogram_ belongs to the image in results_per_point_
+
+    // timing breakdown of the last image, in seconds
+    float calculation_seconds_ = 0.0f;
+    float histogram_seconds_ = 0.0f;
+    float equalization_seconds_ = 0.0f;
+    Clock colorization_clock_;
+    GradientPositions gradient_positions_;
+    int gradient_positions_max_iterations_ = 0;  // max_iterations of gradient_positions_, 0 if they are not valid
+    PixelBuffer colorization_buffer_;
+    std::size_t pixel_origin_ = 0;  // gradient_positions_ and colorization_buffer_ are a ring buffer, image pixel i is at (pixel_origin_ + i) % size
     sf::Image render_buffer_;
 
     void main();
@@ -54,20 +153,50 @@ class Supervisor {
     void handle_message(SupervisorQuit&&);
 
     void start_workers();
+    void place_workers();
     void shutdown_workers();
     void clear_message_queues();
 
-    void send_calculation_messages(const SupervisorImageRequest& image_request);
-    void send_colorization_messages(const int max_iterations, const ImageSize& image_size);
+    [[nodiscard]] bool workers_busy() const { return waiting_for_calculation_results_ > 0 || waiting_for_colorization_results_ > 0; }
+    void cancel_running_calculation();
+    void finish_cancellation();
+    void log_worker_queue_statistics() const;
+    void log_pixel_buffer_statistics() const;
+    void log_timing_breakdown();
+
+    void update_precision(const SupervisorImageRequest& image_request);
+    void update_reference_orbit(const SupervisorImageRequest& image_request);
+
+    [[nodiscard]] int resume_iterations(const SupervisorImageRequest& image_request) const;
+    void update_resumable_image_request(const SupervisorImageRequest& image_request);
+
+    [[nodiscard]] bool should_calculate_progressively(const SupervisorImageRequest& image_request, const int resume_iterations) const;
+    [[nodiscard]] std::vector<CalculationArea> ordered_tiles(const SupervisorImageRequest& image_request, const CalculationArea& area, const int grid_step, const bool skip_coarser_grid);
+    [[nodiscard]] std::int64_t estimated_tile_cost(const CalculationArea& tile) const;
+    void report_tail_time();
+    void send_calculation_messages(const SupervisorImageRequest& image_request, const CalculationArea& area, const int resume_iterations, const int grid_step, const bool skip_coarser_grid);
+    [[nodiscard]] const std::vector<float>* provisional_equalized_iterations(const SupervisorImageRequest& image_request) const;
+    [[nodiscard]] float update_equalized_iterations(const int max_iterations, const std::vector<float>& reference);
+    void colorize_calculated_image(const int max_iterations, const ImageSize& image_size);
+    void colorize_scrolled_strip(const int max_iterations, const SupervisorImageRequest& image_request);
+    void send_colorization_messages(const int max_iterations, const ImageSize& image_size, const CalculationArea& area);
+    void update_texture_from_colorization_buffer(const int row_width, std::size_t begin, const std::size_t end);
 
     bool resize_and_reset_buffers_if_needed(const ImageSize& image_size, const int max_iterations);
+    void allocate_buffers(const ImageSize& image_size, const int max_iterations);
+    void send_first_touch_messages(const ImageSize& image_size, const bool widen_iterations);
+    void log_buffer_memory(const ImageSize& image_size) const;
+    [[nodiscard]] int preferred_worker(const int row);
     void build_iterations_histogram();
 
     void modify_image_request_for_recalculation(SupervisorImageRequest& image_request) const;
 
     [[nodiscard]] bool should_scroll(const SupervisorImageRequest& image_request) const;
+    [[nodiscard]] bool should_zoom(const SupervisorImageRequest& image_request) const;
+    void zoom_results_per_point_array(const SupervisorImageRequest& image_request);
+    [[nodiscard]] std::vector<CalculationArea> areas_around_zoomed_out_image(const ImageSize& image_size) const;
     void scroll_results_per_point_array(const SupervisorImageRequest& image_request);
-    void copy_results_per_point_row(const int dx, const int dy, const int image_width, const int image_height, const int y);
+    void remove_scrolled_off_points_from_histogram(const SupervisorImageRequest& image_request);
 
 public:
     Supervisor(const CommandLine& cli, Window& window);
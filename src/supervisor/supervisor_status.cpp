@@ -27,3 +27,33 @@ void SupervisorStatus::stop_calculation(const Phase new_phase)
     std::lock_guard<std::mutex> lock(mtx_);
     return stopwatch_.is_running();
 }
+
+void SupervisorStatus::set_precision(const PrecisionChoice& precision)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    precision_ = precision;
+}
+
+[[nodiscard]] PrecisionChoice SupervisorStatus::precision()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return precision_;
+}
+
+void SupervisorStatus::clear_tiles()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    tiles_.clear();
+}
+
+void SupervisorStatus::add_tiles(const std::vector<CalculationArea>& tiles)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    tiles_.insert(tiles_.end(), tiles.begin(), tiles.end());
+}
+
+[[nodiscard]] std::vector<CalculationArea> SupervisorStatus::tiles()
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    return tiles_;
+}
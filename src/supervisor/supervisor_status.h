@@ -1,23 +1,64 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <mutex>
+#include <string>
+#include <vector>
 
 #include "clock/stopwatch.h"
+#include "mandelbrot/precision.h"
+#include "messages/messages.h"
 #include "supervisor/phase.h"
 
 class SupervisorStatus {
     std::atomic<Phase> phase_;
+    std::atomic<std::int64_t> iterations_saved_;
+    std::atomic<std::int64_t> calculated_points_;
+    std::atomic<std::int64_t> filled_points_;
+    std::atomic<float> tail_time_;
     Stopwatch stopwatch_;
+    PrecisionChoice precision_{Precision::Double, {}};
+    std::vector<CalculationArea> tiles_;
 
     std::mutex mtx_;
 
 public:
-    SupervisorStatus() : phase_{Phase::Starting} {}
+    SupervisorStatus() : phase_{Phase::Starting}, iterations_saved_{0}, calculated_points_{0}, filled_points_{0}, tail_time_{0.0f} {}
 
     [[nodiscard]] Phase phase() const { return phase_; };
     void set_phase(const Phase phase) { phase_ = phase; };
 
+    // a new image request supersedes the running calculation, only requests that have not been picked up yet block it
+    [[nodiscard]] bool accepts_image_request() const
+    {
+        const Phase phase = phase_;
+        return phase == Phase::Idle || phase == Phase::Calculating || phase == Phase::Coloring || phase == Phase::Canceled;
+    }
+
+    [[nodiscard]] std::int64_t iterations_saved() const { return iterations_saved_; };
+    void set_iterations_saved(const std::int64_t iterations_saved) { iterations_saved_ = iterations_saved; };
+
+    [[nodiscard]] std::int64_t calculated_points() const { return calculated_points_; };
+    [[nodiscard]] std::int64_t filled_points() const { return filled_points_; };
+    void set_point_counts(const std::int64_t calculated_points, const std::int64_t filled_points)
+    {
+        calculated_points_ = calculated_points;
+        filled_points_ = filled_points;
+    };
+
+    // time between the median and the last tile of a calculation
+    [[nodiscard]] float tail_time() const { return tail_time_; };
+    void set_tail_time(const float tail_time) { tail_time_ = tail_time; };
+
+    // tiles of the last calculation pass, for the debug overlay
+    void clear_tiles();
+    void add_tiles(const std::vector<CalculationArea>& tiles);
+    [[nodiscard]] std::vector<CalculationArea> tiles();
+
+    void set_precision(const PrecisionChoice& precision);
+    [[nodiscard]] PrecisionChoice precision();
+
     void start_calculation(const Phase new_phase);
     void stop_calculation(const Phase new_phase);
     [[nodiscard]] Duration calculation_time();
@@ -0,0 +1,15 @@
+#include "tile_order.h"
+
+const char* tile_order_name(const TileOrder tile_order)
+{
+    switch (tile_order) {
+    case TileOrder::RowMajor:
+        return "rows";
+    case TileOrder::CostFirst:
+        return "cost";
+    case TileOrder::CenterOut:
+        return "center";
+    default:
+        return "unknown";
+    }
+}
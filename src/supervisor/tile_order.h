@@ -0,0 +1,10 @@
+#pragma once
+
+// Order in which the tiles of an image are sent to the workers.
+enum class TileOrder {
+    RowMajor,
+    CostFirst,  // most expensive tiles (estimated from the previous image) first
+    CenterOut,
+};
+
+const char* tile_order_name(const TileOrder tile_order);
@@ -0,0 +1,101 @@
+#include "tile_size_tuner.h"
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+[[nodiscard]] int align(const int size, const int alignment)
+{
+    return std::max(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+}  // namespace
+
+[[nodiscard]] std::vector<CalculationArea> fixed_size_tiles(const CalculationArea& area, const int tile_size)
+{
+    std::vector<CalculationArea> tiles;
+
+    for (int y = area.y; y < (area.y + area.height); y += tile_size) {
+        const int height = std::min(area.y + area.height - y, tile_size);
+
+        for (int x = area.x; x < (area.x + area.width); x += tile_size) {
+            const int width = std::min(area.x + area.width - x, tile_size);
+            tiles.push_back(CalculationArea{x, y, width, height});
+        }
+    }
+
+    return tiles;
+}
+
+[[nodiscard]] std::vector<CalculationArea> TileSizeTuner::tiles(const CalculationArea& area, const int tile_size, const int num_threads, const CostFunction& cost) const
+{
+    if (seconds_per_cost_ <= 0.0)
+        return fixed_size_tiles(area, tile_size);
+
+    const int max_tile_size = align(4 * tile_size, alignment);
+    const int min_tile_size = align(tile_size / 4, alignment);
+
+    const std::vector<CalculationArea> coarse_tiles = fixed_size_tiles(area, max_tile_size);
+    std::int64_t total_cost = 0;
+
+    for (const auto& tile : coarse_tiles)
+        total_cost += cost(tile);
+
+    // enough tiles per thread to even out the differences of the estimates, but not so many that the
+    // per tile overhead dominates
+    const double total_seconds = static_cast<double>(total_cost) * seconds_per_cost_;
+    const double target_seconds = std::max(min_tile_seconds, total_seconds / (tiles_per_thread * num_threads));
+
+    std::vector<CalculationArea> tiles;
+
+    for (const auto& tile : coarse_tiles)
+        split(tile, min_tile_size, target_seconds, cost, tiles);
+
+    return tiles;
+}
+
+void TileSizeTuner::split(const CalculationArea& tile, const int min_tile_size, const double target_seconds, const CostFunction& cost, std::vector<CalculationArea>& tiles) const
+{
+    const bool split_x = tile.width >= 2 * min_tile_size;
+    const bool split_y = tile.height >= 2 * min_tile_size;
+
+    if ((!split_x && !split_y) || static_cast<double>(cost(tile)) * seconds_per_cost_ <= target_seconds) {
+        tiles.push_back(tile);
+        return;
+    }
+
+    const int left_width = split_x ? align(tile.width / 2, alignment) : tile.width;
+    const int top_height = split_y ? align(tile.height / 2, alignment) : tile.height;
+
+    for (const CalculationArea& part : {
+             CalculationArea{tile.x, tile.y, left_width, top_height},
+             CalculationArea{tile.x + left_width, tile.y, tile.width - left_width, top_height},
+             CalculationArea{tile.x, tile.y + top_height, left_width, tile.height - top_height},
+             CalculationArea{tile.x + left_width, tile.y + top_height, tile.width - left_width, tile.height - top_height}})
+        if (part.width > 0 && part.height > 0)
+            split(part, min_tile_size, target_seconds, cost, tiles);
+}
+
+void TileSizeTuner::start_calculation()
+{
+    sent_cost_ = 0.0;
+    measured_seconds_ = 0.0;
+}
+
+// Called once all tiles of a pass have been received, so that the next pass of a progressive calculation
+// already uses what was learned from this one.
+void TileSizeTuner::finish_pass()
+{
+    if (sent_cost_ > 0.0 && measured_seconds_ > 0.0) {
+        // average with the previous value to smooth out estimates from images that changed a lot
+        const double seconds_per_cost = measured_seconds_ / sent_cost_;
+        seconds_per_cost_ = seconds_per_cost_ > 0.0 ? 0.5 * (seconds_per_cost_ + seconds_per_cost) : seconds_per_cost;
+
+        spdlog::debug("tile size tuner: {:.3f}s for an estimated cost of {:.0f}, {:.3e}s per unit", measured_seconds_, sent_cost_, seconds_per_cost_);
+    }
+
+    sent_cost_ = 0.0;
+    measured_seconds_ = 0.0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "messages/messages.h"
+
+// Chooses the tile sizes of a calculation from the measured tile times of the previous ones, and of the
+// previous passes of a progressive calculation. All areas of one pass are sent at once, so they share the
+// estimate they started with. Areas start out as tiles of 4x the requested tile size. Tiles that are expected to take
+// longer than the target time are split into quarters, down to 1/4 of the requested tile size,
+// so cheap regions are calculated in few large tiles and expensive regions in many small ones.
+class TileSizeTuner {
+public:
+    using CostFunction = std::function<std::int64_t(const CalculationArea&)>;
+
+private:
+    static constexpr int alignment = 4;  // tile edges stay aligned to the coarsest progressive grid
+    static constexpr int tiles_per_thread = 8;
+    static constexpr double min_tile_seconds = 0.002;
+
+    // calculation time per unit of estimated cost, learned from the previous passes (0: unknown)
+    double seconds_per_cost_ = 0.0;
+
+    // estimated cost of the tiles sent and measured time of the results received for the current pass
+    double sent_cost_ = 0.0;
+    double measured_seconds_ = 0.0;
+
+    void split(const CalculationArea& tile, const int min_tile_size, const double target_seconds, const CostFunction& cost, std::vector<CalculationArea>& tiles) const;
+
+public:
+    [[nodiscard]] std::vector<CalculationArea> tiles(const CalculationArea& area, const int tile_size, const int num_threads, const CostFunction& cost) const;
+
+    void start_calculation();
+    void add_sent_cost(const double cost) { sent_cost_ += cost; }
+    void add_tile_time(const float seconds) { measured_seconds_ += seconds; }
+    void finish_pass();
+};
+
+// Tiles of the given size in row-major order.
+[[nodiscard]] std::vector<CalculationArea> fixed_size_tiles(const CalculationArea& area, const int tile_size);
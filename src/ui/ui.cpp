@@ -4,7 +4,7 @@
 #include <atomic>
 #include <cassert>
 #include <cmath>
-#include <limits>
+#include <initializer_list>
 #include <numbers>
 
 #include <fmt/core.h>
@@ -14,19 +14,22 @@
 #include "clock/duration.h"
 #include "command_line/command_line.h"
 #include "gradient/gradient.h"
+#include "mandelbrot/precision.h"
 #include "messages/messages.h"
 #include "supervisor/supervisor_status.h"
 
 const int default_max_iterations = 5000;
 const int default_tile_size = 100;
 const FractalSection default_fractal_section = {-0.8, 0.0, 2.0};
+const CalculationStrategy default_strategy = CalculationStrategy::Full;
 
 UI::UI(const CommandLine& cli)
     : num_threads_{cli.num_threads()},
-    font_size_{static_cast<float>(cli.font_size())}
+    font_size_{static_cast<float>(cli.font_size())},
+    kernel_{cli.kernel()}
 {
     reset_image_request_input_values_to_default();
-    available_gradients_ = load_available_gradients();
+    available_gradients_ = load_available_gradients(cli.gradient_lookup_table_size());
 }
 
 void UI::reset_image_request_input_values_to_default()
@@ -36,11 +39,12 @@ void UI::reset_image_request_input_values_to_default()
     center_x_.reset(default_fractal_section.center_x);
     center_y_.reset(default_fractal_section.center_y);
     fractal_height_.reset(default_fractal_section.height);
+    strategy_.reset(default_strategy);
 }
 
 [[nodiscard]] bool UI::image_request_input_values_have_changed()
 {
-    return max_iterations_.changed() || tile_size_.changed() || center_x_.changed() || center_y_.changed() || fractal_height_.changed();
+    return max_iterations_.changed() || tile_size_.changed() || center_x_.changed() || center_y_.changed() || fractal_height_.changed() || strategy_.changed();
 }
 
 void UI::render(const Duration elapsed_time, SupervisorStatus& supervisor_status, const ImageSize& window_size)
@@ -77,8 +81,16 @@ void UI::render_main_window(const Duration elapsed_time, SupervisorStatus& super
     ImGui::SameLine();
     ImGui::Text("%dx%d", window_size.width, window_size.height);
 
+    ImGui::TextColored(UserInterface::Colors::light_gray, "kernel:");
+    ImGui::SameLine();
+    ImGui::Text("%s", kernel_name(kernel_));
+
     show_status(phase);
     show_render_time(calculation_running, calculation_time);
+    show_precision(supervisor_status.precision());
+    show_iterations_saved(supervisor_status.iterations_saved());
+    show_filled_points(supervisor_status.calculated_points(), supervisor_status.filled_points());
+    show_tail_time(supervisor_status.tail_time());
 
     if (ImGui::Button("Help (F1)"))
         event_handler_->handle_event(Event::ToggleHelp);
@@ -101,19 +113,31 @@ void UI::render_main_window(const Duration elapsed_time, SupervisorStatus& super
 
     ImGui::NewLine();
 
-    if (input_double("center_x", center_x_, 0.1, 1.0, -5.0, 5.0))
+    if (input_fixed_point("center_x", center_x_, 0.1, 1.0, -5.0, 5.0))
         needs_to_recalculate_image_ = true;
 
-    if (input_double("center_y", center_y_, 0.1, 1.0, -5.0, 5.0))
+    if (input_fixed_point("center_y", center_y_, 0.1, 1.0, -5.0, 5.0))
         needs_to_recalculate_image_ = true;
 
-    if (input_double("fractal height", fractal_height_, 0.1, 1.0, 1000.0 * std::numeric_limits<double>::min(), 10.0))
+    if (input_double("fractal height", fractal_height_, 0.1, 1.0, min_fractal_height(window_size), 10.0))
         needs_to_recalculate_image_ = true;
 
     if (input_int("iterations", max_iterations_, 1000, 10000, 10, 1'000'000))
         needs_to_recalculate_image_ = true;
 
     input_int("tile size", tile_size_, 100, 500, 10, 10'000);
+    ImGui::Checkbox("adaptive tile size", &adaptive_tile_size_);
+    ImGui::SameLine();
+    help("Split tiles that are expected to take long and merge cheap ones (from 1/4 to 4x the tile size), based on the tile times of the previous images and passes.");
+    ImGui::Checkbox("pipelined colorization", &pipelined_colorization_);
+    ImGui::SameLine();
+    help("Colorize the tiles as soon as they are calculated, with the color distribution of the previous image, and recolor the image only if the final distribution differs noticeably.");
+    ImGui::Checkbox("show tiles", &show_tiles_);
+
+    if (show_tiles_)
+        show_tile_sizes(supervisor_status.tiles());
+
+    show_strategy_selection();
 
     if (phase == Phase::Idle) {
         if (ImGui::Button("Calculate"))
@@ -259,12 +283,31 @@ bool UI::input_double(const char* label, InputValue<double>& value, const double
     return changed_now;
 }
 
+bool UI::input_fixed_point(const char* label, InputValue<FixedPoint>& value, const double small_inc, const double big_inc, const double min, const double max)
+{
+    bool changed_now = false;
+    double val = value.get().to_double();
+
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 15);
+
+    // only the double approximation is editable, changing it discards the extra precision
+    if (ImGui::InputDouble(label, &val, small_inc, big_inc, "%.16lf")) {
+        value.set(std::clamp(val, min, max));
+        changed_now = true;
+    }
+
+    ImGui::SameLine();
+    help(fmt::format("{} to {}\n\n     -/+ to change by {}\nCTRL -/+ to change by {}", min, max, small_inc, big_inc));
+
+    return changed_now;
+}
+
 SupervisorImageRequest UI::calculate_image_params(const ImageSize image_size)
 {
     const CalculationArea calculation_area{0, 0, image_size.width, image_size.height};
     const FractalSection fractal_section{center_x_.get(), center_y_.get(), fractal_height_.get()};
 
-    return SupervisorImageRequest{max_iterations_.get(), tile_size_.get(), image_size, calculation_area, {0, 0}, fractal_section};
+    return SupervisorImageRequest{max_iterations_.get(), tile_size_.get(), adaptive_tile_size_, pipelined_colorization_, image_size, calculation_area, {0, 0}, {1, false}, fractal_section, strategy_.get()};
 }
 
 SupervisorImageRequest UI::scroll_image_params(const ImageSize image_size, const int delta_x, const int delta_y)
@@ -277,8 +320,8 @@ SupervisorImageRequest UI::scroll_image_params(const ImageSize image_size, const
     FractalSection fractal_section;
     Scroll scroll{delta_x, delta_y};
 
-    double center_x = center_x_.get();
-    double center_y = center_y_.get();
+    const FixedPoint center_x = center_x_.get();
+    const FixedPoint center_y = center_y_.get();
     double fractal_height = fractal_height_.get();
     double fractal_width = fractal_height * (static_cast<double>(image_size.width) / static_cast<double>(image_size.height));
 
@@ -314,19 +357,32 @@ SupervisorImageRequest UI::scroll_image_params(const ImageSize image_size, const
     center_x_.set(fractal_section.center_x);
     center_y_.set(fractal_section.center_y);
 
-    return SupervisorImageRequest{max_iterations_.get(), tile_size_.get(), image_size, calculation_area, scroll, fractal_section};
+    return SupervisorImageRequest{max_iterations_.get(), tile_size_.get(), adaptive_tile_size_, pipelined_colorization_, image_size, calculation_area, scroll, {1, false}, fractal_section, strategy_.get()};
 }
 
 SupervisorImageRequest UI::zoom_image_params(const ImageSize image_size, double factor)
 {
     spdlog::debug("zoom {}", factor);
 
+    const double min_height = min_fractal_height(image_size);
+
+    if (fractal_height_.get() / factor < min_height) {
+        spdlog::info("zoom limited to a fractal height of {}", min_height);
+        factor = fractal_height_.get() / min_height;
+    }
+
     fractal_height_.set(fractal_height_.get() / factor);
 
     const CalculationArea calculation_area{0, 0, image_size.width, image_size.height};
     const FractalSection fractal_section{center_x_.get(), center_y_.get(), fractal_height_.get()};
+    Zoom zoom = factor >= 1.0 ? Zoom{static_cast<int>(factor), false} : Zoom{static_cast<int>(1.0 / factor), true};
 
-    return SupervisorImageRequest{max_iterations_.get(), tile_size_.get(), image_size, calculation_area, {0, 0}, fractal_section};
+    if (needs_to_recalculate_image_) {
+        // we need to recalculate the image so nothing from the previous image can be reused
+        zoom = Zoom{1, false};
+    }
+
+    return SupervisorImageRequest{max_iterations_.get(), tile_size_.get(), adaptive_tile_size_, pipelined_colorization_, image_size, calculation_area, {0, 0}, zoom, fractal_section, strategy_.get()};
 }
 
 SupervisorColorize UI::colorize_image_params(const ImageSize image_size)
@@ -374,6 +430,83 @@ void UI::show_render_time(bool calculation_running, Duration calculation_time)
         ImGui::Text("%.3fs", calculation_time.as_seconds());
 }
 
+void UI::show_precision(const PrecisionChoice& precision)
+{
+    ImGui::TextColored(UserInterface::Colors::light_gray, "precision:");
+    ImGui::SameLine();
+    ImGui::Text("%s", precision_name(precision.precision));
+    ImGui::SameLine();
+    ImGui::TextColored(UserInterface::Colors::light_gray, "(%s)", precision.reason.c_str());
+}
+
+void UI::show_iterations_saved(const std::int64_t iterations_saved)
+{
+    ImGui::TextColored(UserInterface::Colors::light_gray, "iterations saved:");
+    ImGui::SameLine();
+    ImGui::Text("%s", fmt::format("{}", iterations_saved).c_str());
+}
+
+void UI::show_filled_points(const std::int64_t calculated_points, const std::int64_t filled_points)
+{
+    const std::int64_t total_points = calculated_points + filled_points;
+    const double filled_percentage = total_points > 0 ? 100.0 * static_cast<double>(filled_points) / static_cast<double>(total_points) : 0.0;
+
+    ImGui::TextColored(UserInterface::Colors::light_gray, "filled points:");
+    ImGui::SameLine();
+    ImGui::Text("%s", fmt::format("{} of {} ({:.1f}%)", filled_points, total_points, filled_percentage).c_str());
+}
+
+// Debug overlay with the outlines of the tiles of the last calculation.
+void UI::show_tile_sizes(const std::vector<CalculationArea>& tiles) const
+{
+    if (tiles.empty())
+        return;
+
+    ImDrawList* draw_list = ImGui::GetBackgroundDrawList();
+    const ImU32 outline_color = ImGui::GetColorU32(UserInterface::Colors::tile_outline);
+    int min_size = tiles.front().width;
+    int max_size = tiles.front().width;
+
+    for (const auto& tile : tiles) {
+        const ImVec2 top_left{static_cast<float>(tile.x), static_cast<float>(tile.y)};
+        const ImVec2 bottom_right{static_cast<float>(tile.x + tile.width), static_cast<float>(tile.y + tile.height)};
+        draw_list->AddRect(top_left, bottom_right, outline_color);
+
+        min_size = std::min({min_size, tile.width, tile.height});
+        max_size = std::max({max_size, tile.width, tile.height});
+    }
+
+    ImGui::TextColored(UserInterface::Colors::light_gray, "tiles:");
+    ImGui::SameLine();
+    ImGui::Text("%s", fmt::format("{}, {} to {} pixels", tiles.size(), min_size, max_size).c_str());
+}
+
+void UI::show_tail_time(const float tail_time)
+{
+    ImGui::TextColored(UserInterface::Colors::light_gray, "tail time:");
+    ImGui::SameLine();
+    ImGui::Text("%.3fs", tail_time);
+}
+
+void UI::show_strategy_selection()
+{
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 15);
+
+    if (ImGui::BeginCombo("strategy", calculation_strategy_name(strategy_.get()))) {
+        for (const auto strategy : {CalculationStrategy::Full, CalculationStrategy::Subdivision, CalculationStrategy::Progressive}) {
+            if (ImGui::Selectable(calculation_strategy_name(strategy), strategy_.get() == strategy)) {
+                strategy_.set(strategy);
+                needs_to_recalculate_image_ = true;
+            }
+        }
+
+        ImGui::EndCombo();
+    }
+
+    ImGui::SameLine();
+    help("full: calculate every point\nsubdivision: fill rectangles with a uniform border without calculating their interior\nprogressive: preview at 1/16 and 1/4 resolution first");
+}
+
 void UI::show_gradient_selection()
 {
     ImGui::NewLine();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -8,6 +9,10 @@
 #include "input_value.h"
 #include "event_handler/event_handler.h"
 #include "interface_hidden_hint_window.h"
+#include "mandelbrot/fixed_point.h"
+#include "mandelbrot/kernel.h"
+#include "mandelbrot/precision.h"
+#include "mandelbrot/strategy.h"
 #include "messages/messages.h"
 #include "supervisor/phase.h"
 
@@ -26,11 +31,16 @@ class UI {
     InputValue<int> num_threads_;
     InputValue<int> max_iterations_;
     InputValue<int> tile_size_;
-    InputValue<double> center_x_;
-    InputValue<double> center_y_;
+    InputValue<FixedPoint> center_x_;
+    InputValue<FixedPoint> center_y_;
     InputValue<double> fractal_height_;
+    InputValue<CalculationStrategy> strategy_;
+    bool adaptive_tile_size_ = false;
+    bool pipelined_colorization_ = false;
+    bool show_tiles_ = false;
 
     float font_size_;
+    Kernel kernel_;
 
     bool is_visible_ = true;
     bool show_help_ = false;
@@ -45,6 +55,7 @@ class UI {
     void help(const std::string& text);
     bool input_int(const char* label, InputValue<int>& value, const int small_inc, const int big_inc, const int min, const int max);
     bool input_double(const char* label, InputValue<double>& value, const double small_inc, const double big_inc, const double min, const double max);
+    bool input_fixed_point(const char* label, InputValue<FixedPoint>& value, const double small_inc, const double big_inc, const double min, const double max);
 
     void render_main_window(const Duration elapsed_time, SupervisorStatus& supervisor_status, const ImageSize& window_size);
     void render_help_window();
@@ -55,6 +66,12 @@ class UI {
 
     void show_status(const Phase phase);
     void show_render_time(const bool calculation_running, const Duration calculation_time);
+    void show_precision(const PrecisionChoice& precision);
+    void show_iterations_saved(const std::int64_t iterations_saved);
+    void show_filled_points(const std::int64_t calculated_points, const std::int64_t filled_points);
+    void show_tail_time(const float tail_time);
+    void show_tile_sizes(const std::vector<CalculationArea>& tiles) const;
+    void show_strategy_selection();
     void show_gradient_selection();
 
 public:
@@ -29,7 +29,7 @@ Command ScrollLeftCommand(Window& window, UI& ui, Supervisor& supervisor)
     return [&] {
         spdlog::debug("ScrollLeftCommand");
 
-        if (supervisor.status().phase() == Phase::Idle) {
+        if (supervisor.status().accepts_image_request()) {
             SupervisorImageRequest image_request = ui.scroll_image_params(window.size(), -window.size().height / 8, 0);
             supervisor.calculate_image(image_request);
             ui.set_needs_to_recalculate_image(false);
@@ -42,7 +42,7 @@ Command ScrollRightCommand(Window& window, UI& ui, Supervisor& supervisor)
     return [&] {
         spdlog::debug("ScrollRightCommand");
 
-        if (supervisor.status().phase() == Phase::Idle) {
+        if (supervisor.status().accepts_image_request()) {
             SupervisorImageRequest image_request = ui.scroll_image_params(window.size(), window.size().height / 8, 0);
             supervisor.calculate_image(image_request);
             ui.set_needs_to_recalculate_image(false);
@@ -55,7 +55,7 @@ Command ScrollUpCommand(Window& window, UI& ui, Supervisor& supervisor)
     return [&] {
         spdlog::debug("ScrollUpCommand");
 
-        if (supervisor.status().phase() == Phase::Idle) {
+        if (supervisor.status().accepts_image_request()) {
             SupervisorImageRequest image_request = ui.scroll_image_params(window.size(), 0, -window.size().height / 8);
             supervisor.calculate_image(image_request);
             ui.set_needs_to_recalculate_image(false);
@@ -68,7 +68,7 @@ Command ScrollDownCommand(Window& window, UI& ui, Supervisor& supervisor)
     return [&] {
         spdlog::debug("ScrollDownCommand");
 
-        if (supervisor.status().phase() == Phase::Idle) {
+        if (supervisor.status().accepts_image_request()) {
             SupervisorImageRequest image_request = ui.scroll_image_params(window.size(), 0, window.size().height / 8);
             supervisor.calculate_image(image_request);
             ui.set_needs_to_recalculate_image(false);
@@ -81,7 +81,7 @@ Command ZoomInCommand(Window& window, UI& ui, Supervisor& supervisor)
     return [&] {
         spdlog::debug("ZoomInCommand");
 
-        if (supervisor.status().phase() == Phase::Idle) {
+        if (supervisor.status().accepts_image_request()) {
             SupervisorImageRequest image_request = ui.zoom_image_params(window.size(), 2.0);
             supervisor.calculate_image(image_request);
             ui.set_needs_to_recalculate_image(false);
@@ -94,7 +94,7 @@ Command ZoomOutCommand(Window& window, UI& ui, Supervisor& supervisor)
     return [&] {
         spdlog::debug("ZoomOutCommand");
 
-        if (supervisor.status().phase() == Phase::Idle) {
+        if (supervisor.status().accepts_image_request()) {
             SupervisorImageRequest image_request = ui.zoom_image_params(window.size(), 0.5);
             supervisor.calculate_image(image_request);
             ui.set_needs_to_recalculate_image(false);
@@ -107,7 +107,7 @@ Command CalculateImageCommand(Window& window, UI& ui, Supervisor& supervisor)
     return [&] {
         spdlog::debug("CalculateImageCommand");
 
-        if (supervisor.status().phase() == Phase::Idle) {
+        if (supervisor.status().accepts_image_request()) {
             SupervisorImageRequest image_request = ui.calculate_image_params(window.size());
             supervisor.calculate_image(image_request);
             ui.set_needs_to_recalculate_image(false);
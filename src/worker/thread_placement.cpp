@@ -0,0 +1,134 @@
+#include "thread_placement.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Parse a CPU list like "0-3,8-11".
+[[nodiscard]] std::vector<int> parse_cpu_list(const std::string& list)
+{
+    std::vector<int> cpus;
+    std::istringstream in(list);
+    std::string range;
+
+    while (std::getline(in, range, ',')) {
+        if (range.empty() || range == "\n")
+            continue;
+
+        const auto dash = range.find('-');
+
+        try {
+            const int first = std::stoi(range.substr(0, dash));
+            const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+
+            for (int cpu = first; cpu <= last; ++cpu)
+                cpus.push_back(cpu);
+        } catch (const std::exception&) {
+            return {};
+        }
+    }
+
+    return cpus;
+}
+
+[[nodiscard]] NumaTopology single_node_topology()
+{
+    const int num_cpus = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<int> cpus(static_cast<std::size_t>(num_cpus));
+
+    for (int cpu = 0; cpu < num_cpus; ++cpu)
+        cpus[static_cast<std::size_t>(cpu)] = cpu;
+
+    return NumaTopology{{cpus}};
+}
+
+}  // namespace
+
+[[nodiscard]] NumaTopology numa_topology()
+{
+#ifdef __linux__
+    // nodes can be numbered sparsely, so look at all nodeN directories
+    std::vector<std::pair<int, std::vector<int>>> nodes;
+    std::error_code error;
+
+    for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", error)) {
+        const std::string name = entry.path().filename().string();
+
+        if (name.size() <= 4 || !name.starts_with("node") || !std::all_of(name.begin() + 4, name.end(), [](const char c) { return c >= '0' && c <= '9'; }))
+            continue;
+
+        std::ifstream cpulist(entry.path() / "cpulist");
+        std::string list;
+        std::getline(cpulist, list);
+
+        std::vector<int> cpus = parse_cpu_list(list);
+
+        if (!cpus.empty())
+            nodes.emplace_back(std::stoi(name.substr(4)), std::move(cpus));
+    }
+
+    if (!nodes.empty()) {
+        std::sort(nodes.begin(), nodes.end());
+
+        NumaTopology topology;
+
+        for (auto& node : nodes)
+            topology.node_cpus.push_back(std::move(node.second));
+
+        return topology;
+    }
+#endif
+
+    return single_node_topology();
+}
+
+[[nodiscard]] std::vector<ThreadPlacement> spread_threads(const NumaTopology& topology, const int num_threads)
+{
+    std::vector<ThreadPlacement> placement;
+    std::vector<std::size_t> next_cpu_of_node(topology.node_cpus.size(), 0);
+
+    for (int i = 0; i < num_threads; ++i) {
+        const auto node = static_cast<std::size_t>(i) % topology.node_cpus.size();
+        const auto& cpus = topology.node_cpus[node];
+
+        placement.push_back(ThreadPlacement{cpus[next_cpu_of_node[node]++ % cpus.size()], static_cast<int>(node)});
+    }
+
+    return placement;
+}
+
+bool pin_current_thread_to_cpu(const int cpu)
+{
+#if defined(_WIN32)
+    if (cpu < 0 || cpu >= 64)
+        return false;
+
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu) != 0;
+#elif defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+        return false;
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(static_cast<std::size_t>(cpu), &cpu_set);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+    (void) cpu;
+    return false;
+#endif
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+
+// CPUs of the NUMA nodes of the system. On Linux they are read from /sys/devices/system/node, elsewhere
+// (or if that fails) all CPUs form a single node.
+struct NumaTopology {
+    std::vector<std::vector<int>> node_cpus;
+
+    [[nodiscard]] int number_of_nodes() const { return static_cast<int>(node_cpus.size()); }
+};
+
+// CPU and NUMA node of a thread, cpu is -1 if the thread is not pinned.
+struct ThreadPlacement {
+    int cpu;
+    int node;
+};
+
+[[nodiscard]] NumaTopology numa_topology();
+
+// Spread the threads round-robin over the NUMA nodes, so that already two threads use the memory controllers
+// of two nodes. Within a node each thread gets its own CPU as long as there are enough of them.
+[[nodiscard]] std::vector<ThreadPlacement> spread_threads(const NumaTopology& topology, const int num_threads);
+
+// Restrict the calling thread to one CPU. Returns false if this fails or is not supported on this platform.
+bool pin_current_thread_to_cpu(const int cpu);
@@ -1,17 +1,21 @@
 #include "worker.h"
 
+#include <algorithm>
+
 #include <spdlog/spdlog.h>
 
+#include "clock/clock.h"
 #include "mandelbrot/mandelbrot.h"
 
-Worker::Worker(const int id, MessageQueue<WorkerMessage>& worker_message_queue, MessageQueue<SupervisorMessage>& supervisor_message_queue) :
-    id_{id}, running_{false},
+Worker::Worker(const int id, const ThreadPlacement placement, WorkerQueue& worker_message_queue, MessageQueue<SupervisorMessage>& supervisor_message_queue) :
+    id_{id}, placement_{placement}, running_{false},
     worker_message_queue_{worker_message_queue}, supervisor_message_queue_{supervisor_message_queue}
 {
 }
 
 Worker::Worker(Worker&& other) :
-    id_{other.id_}, running_{other.running_}, thread_{std::move(other.thread_)},
+    id_{other.id_}, placement_{other.placement_}, running_{other.running_}, thread_{std::move(other.thread_)},
+    iterations_histogram_{std::move(other.iterations_histogram_)}, histogram_generation_{other.histogram_generation_},
     worker_message_queue_{other.worker_message_queue_}, supervisor_message_queue_{other.supervisor_message_queue_}
 {
 }
@@ -36,11 +40,18 @@ void Worker::main()
 {
     spdlog::debug("worker {}: started", id_);
 
+    if (placement_.cpu >= 0) {
+        if (pin_current_thread_to_cpu(placement_.cpu))
+            spdlog::debug("worker {}: pinned to CPU {} (NUMA node {})", id_, placement_.cpu, placement_.node);
+        else
+            spdlog::warn("worker {}: could not pin thread to CPU {}", id_, placement_.cpu);
+    }
+
     auto visitor = [&](auto&& msg) { handle_message(std::move(msg)); };
     running_ = true;
 
     while (running_)
-        std::visit(visitor, worker_message_queue_.wait_for_message());
+        std::visit(visitor, worker_message_queue_.wait_for_message(id_));
 
     spdlog::debug("worker {}: stopping", id_);
 }
@@ -49,19 +60,58 @@ void Worker::handle_message(WorkerCalculate&& calculate)
 {
     spdlog::debug("worker {}: received message Calculate area: {}/{} {}x{}", id_, calculate.area.x, calculate.area.y, calculate.area.width, calculate.area.height);
 
-    mandelbrot_calc(calculate.image_size, calculate.fractal_section, calculate.max_iterations, *calculate.results_per_point, calculate.area);
-    draw_pixels(calculate);
-    supervisor_message_queue_.send(SupervisorCalculationResults{calculate.max_iterations, calculate.image_size, calculate.area, calculate.fractal_section, calculate.results_per_point, std::move(calculate.pixels)});
+    Clock clock;
+    const auto statistics = mandelbrot_calc(calculate);
+
+    if (!calculation_canceled(calculate)) {
+        draw_pixels(calculate);
+
+        if (calculate.build_histogram)
+            add_to_iterations_histogram(calculate);
+    }
+
+    const float calculation_time = clock.elapsed_time().as_seconds();
+
+    supervisor_message_queue_.send(SupervisorCalculationResults{calculate.max_iterations, calculate.image_size, calculate.area, calculate.fractal_section, calculate.generation, statistics, calculation_time, calculate.results_per_point, std::move(calculate.pixels)});
 }
 
 void Worker::handle_message(WorkerColorize&& colorize)
 {
-    spdlog::debug("worker {}: received message Colorize start_row: {}, num_rows: {}", id_, colorize.start_row, colorize.num_rows);
+    spdlog::debug("worker {}: received message Colorize start_row: {}, num_rows: {}, start_column: {}, num_columns: {}", id_, colorize.start_row, colorize.num_rows, colorize.start_column, colorize.num_columns);
 
     mandelbrot_colorize(colorize);
     supervisor_message_queue_.send(SupervisorColorizationResults{colorize.start_row, colorize.num_rows, colorize.row_width, colorize.colorization_buffer});
 }
 
+void Worker::handle_message(WorkerFirstTouch&& first_touch)
+{
+    spdlog::debug("worker {}: received message FirstTouch start_row: {}, num_rows: {}", id_, first_touch.start_row, first_touch.num_rows);
+
+    const int end_row = first_touch.start_row + first_touch.num_rows;
+
+    // the rows of the band are rows of the buffers (regardless of scrolling), so the band is a contiguous range
+    // of points in both layouts (including the padding of the tiles)
+    const std::size_t points_begin = first_touch.result_layout.buffer_rows_begin(first_touch.start_row);
+    const std::size_t points_end = first_touch.result_layout.buffer_rows_begin(end_row);
+
+    if (first_touch.widen_iterations) {
+        first_touch.results_per_point->widen_iterations(points_begin, points_end);
+        first_touch.done->count_down();
+        return;
+    }
+
+    first_touch.results_per_point->zero(points_begin, points_end);
+    std::fill(first_touch.orbits_per_point->begin() + static_cast<std::ptrdiff_t>(points_begin), first_touch.orbits_per_point->begin() + static_cast<std::ptrdiff_t>(points_end), OrbitState{});
+
+    const auto pixels_begin = static_cast<std::ptrdiff_t>(first_touch.start_row * first_touch.row_width);
+    const auto pixels_end = static_cast<std::ptrdiff_t>(end_row * first_touch.row_width);
+
+    std::fill(first_touch.gradient_positions->begin() + pixels_begin, first_touch.gradient_positions->begin() + pixels_end, 0.0f);
+    std::fill(first_touch.colorization_buffer->begin() + 4 * pixels_begin, first_touch.colorization_buffer->begin() + 4 * pixels_end, sf::Uint8{0});
+
+    first_touch.done->count_down();
+}
+
 void Worker::handle_message(WorkerQuit&&)
 {
     spdlog::debug("worker {}: received message Quit", id_);
@@ -74,19 +124,58 @@ void Worker::handle_message(WorkerQuit&&)
     return static_cast<sf::Uint8>(255.0f - 255.0f * std::log(static_cast<float>(point.iter)) / log_max_iterations);
 }
 
+// Each worker counts the iterations of its own tiles, so that the supervisor only has to add up one
+// histogram per worker instead of walking the whole image.
+void Worker::add_to_iterations_histogram(const WorkerCalculate& calculate)
+{
+    if (histogram_generation_ != calculate.generation || std::ssize(iterations_histogram_) != calculate.max_iterations + 1) {
+        iterations_histogram_.assign(static_cast<std::size_t>(calculate.max_iterations + 1), 0);
+        histogram_generation_ = calculate.generation;
+    }
+
+    const int x_end = calculate.area.x + calculate.area.width;
+
+    for (int y = calculate.area.y; y < calculate.area.y + calculate.area.height; ++y) {
+        for (int x = calculate.area.x; x < x_end;) {
+            const int run = calculate.result_layout.contiguous_points(x, x_end);
+            const std::size_t point = calculate.result_layout.index(x, y);
+
+            for (int i = 0; i < run; ++i)
+                ++iterations_histogram_[static_cast<std::size_t>(calculate.results_per_point->iter(point + static_cast<std::size_t>(i)))];
+
+            x += run;
+        }
+    }
+}
+
 void Worker::draw_pixels(const WorkerCalculate& calculate)
 {
     const float log_max_iterations = std::log(static_cast<float>(calculate.max_iterations));
     auto p = calculate.pixels.get();
 
+    // points that are not on the calculated grid show the closest calculated point above and left of them
+    const int step = calculate.grid_step;
+
     for (int y = 0; y < calculate.area.height; ++y) {
+        const int grid_y = (y + calculate.area.y) / step * step;
+
         for (int x = 0; x < calculate.area.width; ++x) {
-            const std::size_t point = static_cast<std::size_t>((y + calculate.area.y) * calculate.image_size.width + (x + calculate.area.x));
-            const auto gray = calculation_result_to_grayscale((*calculate.results_per_point)[point], log_max_iterations);
-            *p++ = gray;
-            *p++ = gray;
-            *p++ = gray;
-            *p++ = 255;
+            const int grid_x = (x + calculate.area.x) / step * step;
+            const CalculationResult point = calculate.results_per_point->get(calculate.result_layout.index(grid_x, grid_y));
+
+            if (calculate.provisional_equalized_iterations) {
+                const auto color = point_color(point, calculate.max_iterations, *calculate.provisional_equalized_iterations, *calculate.gradient);
+                *p++ = color.r;
+                *p++ = color.g;
+                *p++ = color.b;
+                *p++ = color.a;
+            } else {
+                const auto gray = calculation_result_to_grayscale(point, log_max_iterations);
+                *p++ = gray;
+                *p++ = gray;
+                *p++ = gray;
+                *p++ = 255;
+            }
         }
     }
 }
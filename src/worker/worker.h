@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -8,32 +9,44 @@
 
 #include "messages/message_queue.h"
 #include "messages/messages.h"
+#include "messages/worker_queue.h"
+#include "thread_placement.h"
 
 class Worker {
     inline static std::mutex mtx_;
 
     const int id_;
+    const ThreadPlacement placement_;
     bool running_;
 
     std::thread thread_;
 
-    MessageQueue<WorkerMessage>& worker_message_queue_;
+    // iterations histogram of the tiles that this worker calculated in histogram_generation_
+    std::vector<int> iterations_histogram_;
+    std::uint64_t histogram_generation_ = 0;
+
+    WorkerQueue& worker_message_queue_;
     MessageQueue<SupervisorMessage>& supervisor_message_queue_;
 
     void main();
 
     void handle_message(WorkerCalculate&& calculate);
     void handle_message(WorkerColorize&& colorize);
+    void handle_message(WorkerFirstTouch&& first_touch);
     void handle_message(WorkerQuit&&);
 
     [[nodiscard]] sf::Uint8 calculation_result_to_grayscale(const CalculationResult& point, const float log_max_iterations);
     void draw_pixels(const WorkerCalculate& calculate);
+    void add_to_iterations_histogram(const WorkerCalculate& calculate);
 
 public:
-    Worker(const int id, MessageQueue<WorkerMessage>& worker_message_queue, MessageQueue<SupervisorMessage>& supervisor_message_queue);
+    Worker(const int id, const ThreadPlacement placement, WorkerQueue& worker_message_queue, MessageQueue<SupervisorMessage>& supervisor_message_queue);
     Worker(Worker&& other);
     ~Worker();
 
     void run();
     void join();
+
+    // only valid after the results of all tiles of the generation have been received
+    [[nodiscard]] const std::vector<int>* iterations_histogram(const std::uint64_t generation) const { return histogram_generation_ == generation ? &iterations_histogram_ : nullptr; }
 };